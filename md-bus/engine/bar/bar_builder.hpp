@@ -1,7 +1,7 @@
 #pragma once
-#include <unordered_map>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "../bus/bus.hpp"
 #include "../common/event.hpp"
@@ -23,14 +23,11 @@ private :
     uint64_t bucket_ns_;
     std::size_t sub_id_{0};
 
-    std::unordered_map<std::string, BarState> state_;
+    // indexed by SymbolId, grown as new symbols show up
+    std::vector<BarState> state_;
 
-    void on_tick(const Event& e) {
-        if(!std::holds_alternative<Tick>(e.p)){
-            return;
-        }
-        //Tick contains symbol, qty, pq
-        const Tick& t = std::get<Tick>(e.p);
+    //Tick contains symbol, qty, pq
+    void on_tick(const Tick& t, const Event& e) {
         uint64_t ts = e.h.ts_ns;
         if(ts == 0) {
             return;
@@ -41,7 +38,9 @@ private :
         //2*bucket_ns_, 3*bucket_ns_) → bucket 2
         uint64_t bucket_id = ts / bucket_ns_;
 
-        auto& st = state_[t.symbol];
+        const uint32_t sym = t.symbol.id();
+        if(sym >= state_.size()) state_.resize(sym + 1);
+        auto& st = state_[sym];
         if(!st.active) {
             st.active = true;
             st.bucket_id = bucket_id;
@@ -82,15 +81,10 @@ private :
     }
 
     void publish_bar(const Bar& b) {
-        Event ev;
-        ev.h.seq = 0;
-        ev.h.ts_ns = b.end_ts_ns;
-        ev.h.topic = Topic::BAR_1S;
-        ev.p = b;
         log_debug("BarBuilder: publishing bar sym={} o={} h={} l={} c={} v={}",
                   b.symbol, b.open, b.high, b.low, b.close, b.volume);
 
-        bus_.publish(ev);
+        bus_.publish<Topic::BAR_1S>(b);
     }
 public :
     static constexpr uint64_t NS_PER_SEC = 1'000'000'000ULL;
@@ -99,9 +93,9 @@ public :
         : bus_(bus)
         , bucket_ns_(bucket_ns)
     {
-        sub_id_ = bus_.subscribe(Topic::MD_TICK,
-                [this](const Event& e) {
-                    on_tick(e);
+        sub_id_ = bus_.subscribe<Topic::MD_TICK>(
+                [this](const Tick& t, const Event& e) {
+                    on_tick(t, e);
                 });
                 
         log_info("BarBuilder: subscribed to MD_TICK (bucket_ns = {})", bucket_ns_);
@@ -114,8 +108,7 @@ public :
     }
 
     void flush_all() {
-        for(auto &kv : state_) {
-            BarState& st = kv.second;
+        for(auto &st : state_) {
             if(!st.active) continue;
             publish_bar(st.bar);
             st.active = false;
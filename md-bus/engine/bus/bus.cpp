@@ -1,15 +1,60 @@
 #include "../bus/bus.hpp"
 #include "../common/event.hpp"
+#include "../common/event_io.hpp"
 #include "../common/log.hpp"
 #include <fmt/core.h>
+#include <algorithm>
 #include "../common/time.hpp"
 
 
 //this is the feature implementation file for bus.hpp
 namespace md {
 
-EventBus::EventBus(size_t ingress_cap_, size_t per_sub_cap_)
-    : ingress_(std::make_unique<BoundedQueue<Event>>(ingress_cap_)),per_sub_cap_{per_sub_cap_}{
+EventBus::EventBus(size_t ingress_cap, size_t per_sub_cap)
+    : EventBus(BusOptions{.ingress_cap = ingress_cap, .per_sub_cap = per_sub_cap}) {}
+
+EventBus::EventBus(const BusOptions& opts)
+    : per_sub_cap_{opts.per_sub_cap},
+      fanout_{opts.fanout},
+      reactor_wait_{opts.reactor_wait},
+      worker_wait_{opts.worker_wait},
+      inline_{opts.exec == ExecMode::Inline}{
+
+    set_perf_sampling(opts.perf_sample_every);
+
+    if(inline_){
+        if(fanout_ != FanoutMode::Queues || opts.worker_threads || opts.reactor_shards > 1 || opts.shared_events){
+            log_warn("EventBus: INLINE exec ignores fanout, worker_threads, reactor_shards and shared_events");
+        }
+    }else if(fanout_ == FanoutMode::Broadcast){
+        bcast_ = std::make_unique<BroadcastRing<Event>>(per_sub_cap_);
+        if(opts.shared_events) log_warn("EventBus: shared_events has no effect with BROADCAST fanout");
+    }else if(opts.worker_threads > 0){
+        pool_ = std::make_unique<WorkerPool>(PoolOptions{
+            .threads = opts.worker_threads,
+            .wait = worker_wait_,
+            .pin = opts.pin_workers,
+            .cpus = opts.worker_cpus,
+            .fifo_priority = opts.worker_fifo_priority,
+        });
+    }
+
+    size_t nshards = opts.reactor_shards && !inline_ ? opts.reactor_shards : 1;
+    if(bcast_ && nshards > 1){
+        log_warn("EventBus: BROADCAST fanout runs a single reactor, ignoring reactor_shards = {}", nshards);
+        nshards = 1;
+    }
+    for(size_t i = 0; i < nshards; ++i){
+        auto sh = std::make_unique<Shard>();
+        sh->index = i;
+        if(!inline_) sh->ingress = std::make_unique<MpscRing<Event>>(opts.ingress_cap);
+        sh->routes = std::make_shared<RouteTable>();
+        if(opts.shared_events && !bcast_ && !inline_){
+            event_pools_.push_back(std::make_unique<EventPool>());
+            sh->event_pool = event_pools_.back().get();
+        }
+        shards_.push_back(std::move(sh));
+    }
 
     for(auto &c : topic_counts_){
         c.store(0, std::memory_order_relaxed);
@@ -17,10 +62,20 @@ EventBus::EventBus(size_t ingress_cap_, size_t per_sub_cap_)
 
     perf_start_ns_ = md::now_ns();
 
-    log_info("EventBus starting (ingress_cap = {}, per_sub_cap = {})",
-            ingress_cap_, per_sub_cap_);
- 
-    reactor_ = std::thread([this]{reactor_loop();});
+    log_info("EventBus starting (ingress_cap = {}, per_sub_cap = {}, fanout = {}, exec = {}, shards = {}, reactor_wait = {}, worker_wait = {})",
+            opts.ingress_cap, per_sub_cap_, to_string(fanout_), to_string(opts.exec), shards_.size(),
+            to_string(reactor_wait_), to_string(worker_wait_));
+    if(inline_) return;
+
+    for(auto &sh : shards_){
+        ThreadConfig tc = opts.reactor_thread;
+        if(shards_.size() > 1) tc.name = fmt::format("{}-{}", tc.name, sh->index);
+        if(!opts.shard_cpus.empty()) tc.cpu = opts.shard_cpus[sh->index % opts.shard_cpus.size()];
+        sh->th = std::thread([this, s = sh.get(), tc]{
+            apply_thread_config(tc);
+            reactor_loop(*s);
+        });
+    }
 }
 
 EventBus::~EventBus() { stop(); }
@@ -30,150 +85,307 @@ EventBus::~EventBus() { stop(); }
 //to call the callback function on the things published 
 //the joining to the main thread happens in unsubscribe portion
 SubId EventBus::subscribe(Topic T, Callback cb){
-    auto id = next_id_.fetch_add(1, std::memory_order_relaxed);
-    auto slot = std::make_unique<SubSlot>();
-    slot->t = T;
-    slot->q = std::make_unique<BoundedQueue<Event>>(per_sub_cap_);
-    slot->cb = std::move(cb);
-    slot->worker = std::thread([this, s = slot.get()]{ // s is a lamda capture with c++14 and up (lamda local variable)
-    // .get() returns a SubSlot* raw pointer
-    Event ev;
-    while (s->run.load(std::memory_order_relaxed)) {
-      if (s->q->pop(ev)) {
-        // Ignore unsubscribe wake-up sentinel
-        if (ev.h.ts_ns == 0 && ev.h.t_pub_ns == 0 && ev.h.seq == 0) {
-            continue;
-        }
-         if (perf_enabled_.load(std::memory_order_relaxed) && ev.h.t_pub_ns != 0) {
-                const uint64_t t_cb_ns = md::now_ns();
-                const uint64_t lat_ns = (t_cb_ns >= ev.h.t_pub_ns) ? (t_cb_ns - ev.h.t_pub_ns) : 0;
-                std::scoped_lock lk(perf_mu_);
-                latency_ns_hist_.record(lat_ns);
-            }
+    return add_sub(T, false, std::move(cb), SubOptions{});
+}
 
-            // OPTIONAL: trace at callback boundary
-            if (reactor_trace_.load(std::memory_order_relaxed)) {
-                md::log_debug("[CB] seq={} topic={}", ev.h.seq, (int)ev.h.topic);
-            }
+SubId EventBus::subscribe(Topic T, Callback cb, const SubOptions& opts){
+    return add_sub(T, false, std::move(cb), opts);
+}
 
-        s->cb(ev); // execute user callback(that was passed during subscribe)
-      }
-    }
-    // optional: drain remaining events before exit
-    while (s->q->size() > 0) {
-      s->q->pop(ev);
-      // Ignore unsubscribe wake-up sentinel
-      if (ev.h.ts_ns == 0 && ev.h.t_pub_ns == 0 && ev.h.seq == 0) {
-          continue;
-      }
-      if (perf_enabled_.load(std::memory_order_relaxed) &&  ev.h.t_pub_ns != 0) {
-            const uint64_t t_cb_ns = md::now_ns();
-            const uint64_t lat_ns = (t_cb_ns >= ev.h.t_pub_ns) ? (t_cb_ns - ev.h.t_pub_ns) : 0;
-            std::scoped_lock lk(perf_mu_);
-            latency_ns_hist_.record(lat_ns);
-        }
+SubId EventBus::subscribe_all(Callback cb){
+    return add_sub(Topic::MD_TICK, true, std::move(cb), SubOptions{}); // topic irrelevant, all msg will be sent
+}
 
-        if (reactor_trace_.load(std::memory_order_relaxed)) {
-            md::log_debug("[CB-DRAIN] seq={} topic={}", ev.h.seq, (int)ev.h.topic);
+SubId EventBus::subscribe_all(Callback cb, const SubOptions& opts){
+    return add_sub(Topic::MD_TICK, true, std::move(cb), opts);
+}
+
+SubId EventBus::add_sub(Topic t, bool all, Callback cb, const SubOptions& opts){
+    auto id = next_id_.fetch_add(1, std::memory_order_relaxed);
+    auto slot = std::make_shared<SubSlot>();
+    slot->bus = this;
+    slot->id = id;
+    slot->t = t;
+    slot->all = all;
+    slot->opts = opts;
+    slot->wait = opts.wait.value_or(worker_wait_);
+    if(pool_ && opts.wait && *opts.wait != worker_wait_){
+        log_warn("sub '{}': wait strategy {} ignored, pool workers use {}",
+                 opts.name, to_string(*opts.wait), to_string(worker_wait_));
+        slot->wait = worker_wait_;
+    }
+    const size_t cap = opts.capacity ? opts.capacity : per_sub_cap_;
+    slot->cb = std::move(cb); // remember to move
+    // .get() returns a SubSlot* raw pointer, the slot outlives the worker
+    slot->shards.assign(shards_.size(), opts.shards.empty() ? 1 : 0);
+    for(size_t i : opts.shards){
+        if(i < shards_.size()) slot->shards[i] = 1;
+        else log_warn("sub '{}': no reactor shard {}, bus has {}", opts.name, i, shards_.size());
+    }
+    slot->notify_pending.assign(shards_.size(), 0);
+    slot->field_filter = opts.filter.by_fields();
+    ThreadConfig tc = opts.thread;
+    if(tc.name.empty()) tc.name = "sub-" + (opts.name.empty() ? std::to_string(id) : opts.name);
+    if(inline_){
+        // nothing to set up: route_inline() calls cb straight away
+    }else if(bcast_){
+        slot->cursor = bcast_->add_reader();
+        slot->worker = std::thread([this, s = slot.get(), tc]{
+            apply_thread_config(tc);
+            reader_loop(s);
+        });
+    }else{
+        if(opts.conflate_by_symbol){
+            slot->cq = std::make_unique<ConflatingQueue>(cap);
+        }else if(opts.overflow == OverflowPolicy::Conflate){
+            slot->cq = std::make_unique<ConflatingQueue>(cap, ConflatingQueue::Mode::WhenFull);
+        }else if(opts.overflow == OverflowPolicy::DropOldest){
+            if(!event_pools_.empty()) slot->rlq = std::make_unique<BoundedQueue<EventRef>>(cap);
+            else slot->lq = std::make_unique<BoundedQueue<Event>>(cap);
+        }else{
+            // one SPSC lane per attached shard: every lane has a single producer
+            for(size_t i = 0; i < shards_.size(); ++i){
+                const bool on = slot->shards[i];
+                if(shards_[i]->event_pool) slot->rq.push_back(on ? std::make_unique<SpscRing<EventRef>>(cap) : nullptr);
+                else slot->q.push_back(on ? std::make_unique<SpscRing<Event>>(cap) : nullptr);
+            }
         }
-      s->cb(ev);
+        if(pool_) pool_->attach(*slot);
+        else slot->worker = std::thread([this, s = slot.get(), tc]{
+            apply_thread_config(tc);
+            worker_loop(s);
+        });
     }
-  });
     {
         std::scoped_lock lk(mu_);
-        subs_.emplace(id, std::move(slot));
+        if(all) all_subs_.emplace(id, std::move(slot));
+        else subs_.emplace(id, std::move(slot));
+        rebuild_routes_locked();
     }
     return id;
 }
 
-SubId EventBus::subscribe_all(Callback cb){
-    auto id = next_id_.fetch_add(1, std::memory_order_relaxed);
-    auto slot = std::make_unique<SubSlot>();
-    slot->t = Topic::MD_TICK; // irrelevant all msg will be sent
-    slot->q = std::make_unique<BoundedQueue<Event>>(per_sub_cap_);
-    slot->cb = std::move(cb); // remember to move
-    slot->worker = std::thread([this, s = slot.get()]{
-        Event ev;
-        while(s->run.load(std::memory_order_relaxed)){
-            if(s->q->pop(ev)){
-                // Ignore unsubscribe wake-up sentinel
-                if (ev.h.ts_ns == 0 && ev.h.t_pub_ns == 0 && ev.h.seq == 0) {
-                    continue;
-                }
-                if (perf_enabled_.load(std::memory_order_relaxed) && ev.h.t_pub_ns != 0) {
-                const uint64_t t_cb_ns = md::now_ns();
-                const uint64_t lat_ns = (t_cb_ns >= ev.h.t_pub_ns) ? (t_cb_ns - ev.h.t_pub_ns) : 0;
-                std::scoped_lock lk(perf_mu_);
-                latency_ns_hist_.record(lat_ns);
+// off the hot path: build a fresh table and swap it in
+void EventBus::rebuild_routes_locked(){
+    // subscription order within each list, so Inline dispatch is deterministic
+    auto by_id = [](const auto& a, const auto& b){ return a->id < b->id; };
+    // symbol-filtered slots go under each of their symbols (once per symbol)
+    auto place = [](const std::shared_ptr<SubSlot>& slot, SlotList& plain,
+                    std::vector<SlotList>& by_sym, bool& indexed){
+        if(!slot->opts.filter.by_symbol()){
+            plain.push_back(slot);
+            return;
+        }
+        auto syms = slot->opts.filter.symbols;
+        std::sort(syms.begin(), syms.end());
+        syms.erase(std::unique(syms.begin(), syms.end()), syms.end());
+        for(SymbolId sym : syms){
+            if(sym.id() >= by_sym.size()) by_sym.resize(sym.id() + 1);
+            by_sym[sym.id()].push_back(slot);
+        }
+        indexed = true;
+    };
+    for(auto &sh : shards_){
+        auto rt = std::make_shared<RouteTable>();
+        for(auto &kv : subs_){
+            if(!kv.second->run.load(std::memory_order_relaxed)) continue; // unsubscribing
+            auto idx = static_cast<size_t>(kv.second->t);
+            if(idx < kTopicCount && kv.second->shards[sh->index]){
+                place(kv.second, rt->by_topic[idx], rt->by_symbol[idx], rt->indexed);
             }
+        }
+        for(auto &kv : all_subs_){
+            if(!kv.second->run.load(std::memory_order_relaxed)) continue;
+            if(kv.second->shards[sh->index]) place(kv.second, rt->all, rt->all_by_symbol, rt->indexed);
+        }
+        for(auto &v : rt->by_topic) std::sort(v.begin(), v.end(), by_id);
+        std::sort(rt->all.begin(), rt->all.end(), by_id);
+        for(auto &m : rt->by_symbol) for(auto &l : m) std::sort(l.begin(), l.end(), by_id);
+        for(auto &l : rt->all_by_symbol) std::sort(l.begin(), l.end(), by_id);
+        std::atomic_store_explicit(&sh->routes, std::shared_ptr<const RouteTable>(std::move(rt)),
+                                   std::memory_order_release);
+    }
+    routes_version_.fetch_add(1, std::memory_order_release);
+}
 
-            if (reactor_trace_.load(std::memory_order_relaxed)) {
-                md::log_debug("[CB-ALL] seq={} topic={}", ev.h.seq, (int)ev.h.topic);
-            }
-                s->cb(ev);
+// every subscriber ev should go to, in subscription order: the topic's
+// subscribers (plain ones merged with those indexed under ev's symbol),
+// then subscribe_all ones the same way. Price/qty/custom filters are
+// checked here; symbol filters are already done by the index.
+template <typename F>
+void EventBus::for_each_route(const RouteTable& rt, const Event& ev, F&& f){
+    const auto idx = static_cast<size_t>(ev.h.topic);
+    const SlotList* topic_sym = nullptr;
+    const SlotList* all_sym = nullptr;
+    if(rt.indexed){
+        const uint32_t sym = symbol_of(ev.p).id();
+        if(sym != 0){
+            if(idx < kTopicCount && sym < rt.by_symbol[idx].size() && !rt.by_symbol[idx][sym].empty()){
+                topic_sym = &rt.by_symbol[idx][sym];
             }
+            if(sym < rt.all_by_symbol.size() && !rt.all_by_symbol[sym].empty()) all_sym = &rt.all_by_symbol[sym];
         }
-        while(s->q->size() > 0){
-            s->q->pop(ev);
-            // Ignore unsubscribe wake-up sentinel
-            if (ev.h.ts_ns == 0 && ev.h.t_pub_ns == 0 && ev.h.seq == 0) {
-                continue;
-            }
-            if (perf_enabled_.load(std::memory_order_relaxed) && ev.h.t_pub_ns != 0) {
-            const uint64_t t_cb_ns = md::now_ns();
-            const uint64_t lat_ns = (t_cb_ns >= ev.h.t_pub_ns) ? (t_cb_ns - ev.h.t_pub_ns) : 0;
-            std::scoped_lock lk(perf_mu_);
-            latency_ns_hist_.record(lat_ns);
-            }
+    }
+    auto visit = [&ev, &f](const std::shared_ptr<SubSlot>& s){
+        if(!s->field_filter || s->opts.filter.matches_fields(ev)) f(s);
+    };
+    auto merged = [&visit](const SlotList* a, const SlotList* b){
+        if(!b){
+            if(a) for(auto& s : *a) visit(s);
+            return;
+        }
+        const size_t na = a ? a->size() : 0;
+        size_t i = 0, j = 0;
+        while(i < na || j < b->size()){
+            if(j == b->size() || (i < na && (*a)[i]->id < (*b)[j]->id)) visit((*a)[i++]);
+            else visit((*b)[j++]);
+        }
+    };
+    merged(idx < kTopicCount ? &rt.by_topic[idx] : nullptr, topic_sym);
+    merged(&rt.all, all_sym);
+}
+
+void EventBus::worker_loop(SubSlot* s){
+    for(;;){
+        s->bell.wait([s]{
+            return !s->empty() || !s->run.load(std::memory_order_acquire);
+        }, s->wait);
+        while(s->deliver_next()){}
+        if(!s->run.load(std::memory_order_acquire)){
+            // drain whatever the reactor pushed before we were unlinked
+            while(s->deliver_next()){}
+            break;
+        }
+    }
+}
+
+// Broadcast mode: walk the shared ring through our own cursor, skipping
+// topics we did not subscribe to. Events are read in place, never copied.
+void EventBus::reader_loop(SubSlot* s){
+    auto& cur = *s->cursor;
+    for(;;){
+        bcast_bell_.wait([this, s]{
+            return bcast_->available(*s->cursor) || !s->run.load(std::memory_order_acquire);
+        }, s->wait);
+        const bool stopping = !s->run.load(std::memory_order_acquire);
+        uint64_t next = cur.next.load(std::memory_order_relaxed);
+        const uint64_t end = bcast_->published();
+        for(; next < end; ++next){
+            const Event& ev = bcast_->at(next);
+            if((s->all || ev.h.topic == s->t) && s->opts.filter.matches(ev)) deliver(*s, ev);
+            // release: the reactor may reuse this slot once we move past it
+            cur.next.store(next + 1, std::memory_order_release);
+        }
+        if(stopping) break;
+    }
+}
+
+// Pool mode: one run of a subscription strand. Once unsubscribe() has
+// dropped run, the next run drains everything and retires the strand.
+StrandState EventBus::drain(SubSlot& s, size_t budget){
+    if(!s.run.load(std::memory_order_seq_cst)){
+        while(s.deliver_next()){}
+        retire_slot(s);
+        s.retired.store(true, std::memory_order_release);
+        s.bell.ring(); // unsubscribe() parks on it
+        return StrandState::Retired;
+    }
+    for(size_t n = 0; n < budget; ++n){
+        if(!s.deliver_next()) return StrandState::Idle;
+    }
+    return s.empty() ? StrandState::Idle : StrandState::More;
+}
+
+void EventBus::deliver(SubSlot& s, const Event& ev){
+    bool perf = perf_enabled_.load(std::memory_order_relaxed) && ev.h.t_pub_ns != 0;
+    if (perf && ++s.sample_ctr < perf_sample_every_.load(std::memory_order_relaxed)) perf = false;
+    else if (perf) s.sample_ctr = 0;
+    const uint64_t t_cb_ns = perf ? md::now_ns() : 0;
 
-            if (reactor_trace_.load(std::memory_order_relaxed)) {
-                md::log_debug("[CB-ALL-DRAIN] seq={} topic={}", ev.h.seq, (int)ev.h.topic);
+    // OPTIONAL: trace at callback boundary
+    if (reactor_trace_.load(std::memory_order_relaxed)) {
+        md::log_debug("{} seq={} topic={}", s.all ? "[CB-ALL]" : "[CB]",
+                      ev.h.seq, (int)ev.h.topic);
+    }
+
+    s.cb(ev); // execute user callback(that was passed during subscribe)
+    // single writer: plain store, no RMW
+    s.delivered.store(s.delivered.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    if (perf) {
+        const uint64_t t_done_ns = md::now_ns();
+        const uint64_t lat_ns = (t_cb_ns >= ev.h.t_pub_ns) ? (t_cb_ns - ev.h.t_pub_ns) : 0;
+        const uint64_t cb_ns = t_done_ns - t_cb_ns;
+        s.hist.lat.record(lat_ns);
+        s.hist.cb.record(cb_ns);
+        const auto idx = static_cast<size_t>(ev.h.topic);
+        if (s.all && idx < kTopicCount) {
+            auto* th = s.topic_hist[idx].load(std::memory_order_relaxed);
+            if (!th) {
+                th = new SubSlot::Hists();
+                s.topic_hist[idx].store(th, std::memory_order_release);
             }
-            s->cb(ev);
+            th->lat.record(lat_ns);
+            th->cb.record(cb_ns);
         }
-    });
-    {
-        std::scoped_lock lk(mu_);
-        all_subs_.emplace(id, std::move(slot));
     }
-    return id;
 }
 
 //join back from the information stored in SubSlot
-//first check joinable(fanning out the left over Event in the subqueue)
+//the slot is unlinked from the routing table first, then the worker is told
+//to drain what is left and exit. It stays in subs_ (so stats keep counting
+//it) until retire_slot() moves its numbers into the retired totals.
 void EventBus::unsubscribe(SubId id){
-    auto s = std::make_unique<SubSlot>();
+    std::shared_ptr<SubSlot> s;
     {
         std::scoped_lock lk(mu_);
         auto it = subs_.find(id);
         if(it != subs_.end()){
-            s = std::move(it->second);
-            subs_.erase(it);
+            s = it->second;
         }else{
             auto it2 = all_subs_.find(id);
             if(it2 == all_subs_.end())return;
-            s = std::move(it2->second);
-            all_subs_.erase(it2);
+            s = it2->second;
         }
+        // already on its way out
+        if(!s->run.exchange(false, std::memory_order_seq_cst)) return;
+        rebuild_routes_locked(); // skips slots whose run is down
     }
-    s->run.store(false, std::memory_order_relaxed);
-    s->q->push(Event{}); // this can trigger the pop to wake up the worker if it's waiting
-    //but this will run the callback with an empty Event
+    // the reactor may still hold the previous snapshot for one more event;
+    // enqueue() gives up on a slot whose run flag is down
+    if(pool_){
+        pool_->schedule(s); // force one last run, it will retire the strand
+        // from a callback (a pool worker) waiting could deadlock: our own
+        // strand can't rerun while we're in it, and every worker may end
+        // up blocked here. The retiring run finishes the job on its own.
+        if(pool_->on_worker()) return;
+        s->bell.wait([&s]{ return s->retired.load(std::memory_order_acquire); });
+        return;
+    }
+    bell_of(*s).ring(); // wake the worker if it's parked
     if(s->worker.joinable()) s->worker.join();
+    if(s->cursor) bcast_->remove_reader(s->cursor); // stop gating the reactor
+    retire_slot(*s);
+}
+
+// its consumer is done: drop it from the live maps and keep its numbers in
+// the bus totals, in one step under mu_ so stats never miss or double it
+void EventBus::retire_slot(SubSlot& s){
+    std::scoped_lock lk(mu_);
+    if(subs_.erase(s.id) == 0) all_subs_.erase(s.id);
+    dropped_retired_.fetch_add(s.dropped.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    fold_perf(s, retired_perf_);
 }
 
-//Increments Sequence and Pushes to Ingress : non blocking
+//Increments Sequence and Pushes to Ingress
 bool EventBus::publish(Event e){
     e.h.seq = seq_.fetch_add(1, std::memory_order_relaxed);
-    e.h.ts_ns = now_ns();
+    // one clock read stamps both: they only differed by the cost of the call
+    const uint64_t now = now_ns();
+    e.h.ts_ns = now;
+    if (perf_enabled_.load(std::memory_order_relaxed)) e.h.t_pub_ns = now;
 
-    published_.fetch_add(1, std::memory_order_relaxed);
-    // inside publish(...)
-    if (perf_enabled_.load(std::memory_order_relaxed)) {
-        e.h.t_pub_ns = md::now_ns();
-    }
-
-    return ingress_->push(std::move(e));  // remember ingress_ is a pointer;
+    return push_ingress(std::move(e));
 }
 
 bool EventBus::publish_preserve(Event e){
@@ -184,89 +396,341 @@ bool EventBus::publish_preserve(Event e){
         e.h.ts_ns = now_ns();
     }
     if (e.h.t_pub_ns == 0) e.h.t_pub_ns = e.h.ts_ns;
-    published_.fetch_add(1, std::memory_order_relaxed);
-    return ingress_->push(std::move(e));
+    return push_ingress(std::move(e));
 }
 
-// Routes Events to Subscribers with matching topic
-void EventBus::reactor_loop() {
-    Event ev;
-    while(run_.load(std::memory_order_relaxed)){
-        if(!ingress_->pop(ev)) continue;
+// a failed try_publish still consumes its seq number, so receivers may see gaps
+bool EventBus::try_publish(Event e){
+    e.h.seq = seq_.fetch_add(1, std::memory_order_relaxed);
+    const uint64_t now = now_ns();
+    e.h.ts_ns = now;
+    if (perf_enabled_.load(std::memory_order_relaxed)) e.h.t_pub_ns = now;
+
+    if(inline_) return dispatch_inline(&e, 1);
+    Shard& sh = *shards_[shard_of(e)];
+    if(!sh.ingress->try_push(std::move(e))){
+        ingress_full_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    published_.fetch_add(1, std::memory_order_relaxed);
+    sh.bell.ring();
+    return true;
+}
 
-        if (ev.h.ts_ns == 0 && ev.h.t_pub_ns == 0 && ev.h.seq == 0) {
-            continue;
+void EventBus::stamp_batch(Event* first, size_t n, bool preserve_ts){
+    const uint64_t seq0 = seq_.fetch_add(n, std::memory_order_relaxed);
+    const uint64_t now = now_ns();
+    const bool perf = perf_enabled_.load(std::memory_order_relaxed);
+    for(size_t i = 0; i < n; ++i){
+        Header& h = first[i].h;
+        h.seq = seq0 + i;
+        if(!preserve_ts || h.ts_ns == 0) h.ts_ns = now;
+        if(preserve_ts){
+            if(h.t_pub_ns == 0) h.t_pub_ns = h.ts_ns;
+        }else if(perf){
+            h.t_pub_ns = now;
         }
+    }
+}
 
-          if (reactor_trace_.load(std::memory_order_relaxed)) {
-            md::log_debug("[REACTOR] seq={} topic={}", ev.h.seq, (int)ev.h.topic);
-            // If you changed Event to have ev.seq/ev.topic, then use:
-            // md::log_debug("[REACTOR] seq={} topic={}", ev.seq, (int)ev.topic);
-        }
-        
-        ingress_popped_.fetch_add(1, std::memory_order_relaxed);
-        if(ev.h.ts_ns != 0){
-            auto idx = static_cast<int>(ev.h.topic);
-            if(idx < kMaxTopics) {
-                topic_counts_[idx].fetch_add(1, std::memory_order_relaxed);
-            }
-        }
+bool EventBus::publish_batch(Event* first, size_t n){
+    if(n == 0) return true;
+    stamp_batch(first, n, false);
+    return push_ingress_batch(first, n);
+}
 
-        std::scoped_lock lk(mu_);
-        for(auto &kv : subs_){
-            auto &slot = kv.second;
-            if(slot->t == ev.h.topic) slot->q->push(ev);
-        }
-        for(auto &kv : all_subs_){
-            auto &slot = kv.second;
-            slot->q->push(ev);
-        }
+bool EventBus::publish_batch_preserve(Event* first, size_t n){
+    if(n == 0) return true;
+    stamp_batch(first, n, true);
+    return push_ingress_batch(first, n);
+}
+
+bool EventBus::push_ingress_batch(Event* first, size_t n){
+    if(inline_) return dispatch_inline(first, n);
+    if(shards_.size() == 1) return push_shard_batch(*shards_[0], first, n);
+
+    // group by shard (stable, so per-symbol order holds), then one claim
+    // per shard group
+    thread_local std::vector<Event> grouped;
+    thread_local std::vector<size_t> shard_ids;
+    thread_local std::vector<size_t> offsets;
+    shard_ids.resize(n);
+    offsets.assign(shards_.size() + 1, 0);
+    for(size_t i = 0; i < n; ++i){
+        shard_ids[i] = shard_of(first[i]);
+        ++offsets[shard_ids[i] + 1];
     }
-    while(ingress_->size() > 0){
-        ingress_->pop(ev);
+    for(size_t k = 1; k < offsets.size(); ++k) offsets[k] += offsets[k - 1];
+    grouped.resize(n);
+    std::vector<size_t> pos(offsets.begin(), offsets.end() - 1);
+    for(size_t i = 0; i < n; ++i) grouped[pos[shard_ids[i]]++] = std::move(first[i]);
+
+    bool ok = true;
+    for(size_t k = 0; k < shards_.size(); ++k){
+        const size_t cnt = offsets[k + 1] - offsets[k];
+        if(cnt) ok = push_shard_batch(*shards_[k], grouped.data() + offsets[k], cnt) && ok;
+    }
+    return ok;
+}
 
-        if (ev.h.ts_ns == 0 && ev.h.t_pub_ns == 0 && ev.h.seq == 0) {
-            continue;
+bool EventBus::push_shard_batch(Shard& sh, Event* first, size_t n){
+    // claim at most half the ring at a time so a batch can't starve behind
+    // single-event publishers
+    const size_t max_chunk = std::max<size_t>(1, sh.ingress->capacity() / 2);
+    size_t done = 0;
+    while(done < n){
+        const size_t chunk = std::min(max_chunk, n - done);
+        while(!sh.ingress->try_push_n(first + done, chunk)){
+            if(!run_.load(std::memory_order_relaxed)) return false;
+            sh.bell.ring();
+            std::this_thread::yield();
         }
+        done += chunk;
+        published_.fetch_add(chunk, std::memory_order_relaxed);
+    }
+    sh.bell.ring();
+    return true;
+}
 
-        ingress_popped_.fetch_add(1, std::memory_order_relaxed);
-        if(ev.h.ts_ns != 0) {
-            auto idx = static_cast<int>(ev.h.topic);
-            if(idx < kMaxTopics){
-                topic_counts_[idx].fetch_add(1, std::memory_order_relaxed);
-            }
-        }
+// blocking only when the shard's ingress is full: back off until its
+// reactor catches up
+bool EventBus::push_ingress(Event&& e){
+    if(inline_) return dispatch_inline(&e, 1);
+    Shard& sh = *shards_[shard_of(e)];
+    while(!sh.ingress->try_push(std::move(e))){
+        if(!run_.load(std::memory_order_relaxed)) return false;
+        std::this_thread::yield();
+    }
+    published_.fetch_add(1, std::memory_order_relaxed);
+    sh.bell.ring();
+    return true;
+}
+
+// Inline: queue, and drain unless a dispatch further up the stack (we are
+// inside a callback) will do it
+bool EventBus::dispatch_inline(Event* first, size_t n){
+    if(!run_.load(std::memory_order_relaxed)) return false;
+    for(size_t i = 0; i < n; ++i) inline_q_.push_back(std::move(first[i]));
+    published_.fetch_add(n, std::memory_order_relaxed);
+    if(inline_busy_) return true;
+
+    struct Busy {
+        bool& b;
+        explicit Busy(bool& f) : b{f} { b = true; }
+        ~Busy() { b = false; } // a throwing callback must not wedge the bus
+    } busy{inline_busy_};
+    while(!inline_q_.empty()){
+        const Event ev = std::move(inline_q_.front());
+        inline_q_.pop_front();
+        route_inline(ev);
+    }
+    return true;
+}
+
+void EventBus::route_inline(const Event& ev){
+    ingress_popped_.fetch_add(1, std::memory_order_relaxed);
+    const auto idx = static_cast<size_t>(ev.h.topic);
+    if(idx < kTopicCount) topic_counts_[idx].fetch_add(1, std::memory_order_relaxed);
+
+    Shard& sh = *shards_[0];
+    sh.routed.fetch_add(1, std::memory_order_relaxed);
+    const uint64_t v = routes_version_.load(std::memory_order_acquire);
+    if(v != sh.reactor_routes_version){
+        sh.reactor_routes = std::atomic_load_explicit(&sh.routes, std::memory_order_acquire);
+        sh.reactor_routes_version = v;
+    }
+    // callbacks may (un)subscribe, which swaps sh.reactor_routes on the next
+    // event; keep this one alive until we are done with it
+    const auto rt = sh.reactor_routes;
+    for_each_route(*rt, ev, [this, &ev](const std::shared_ptr<SubSlot>& slot){
+        if(slot->run.load(std::memory_order_relaxed)) deliver(*slot, ev);
+    });
+}
+
+size_t EventBus::shard_of(const Event& e) const {
+    if(shards_.size() == 1) return 0;
+    // ids are dense, so this spreads symbols evenly
+    return symbol_of(e.p).id() % shards_.size();
+}
+
+// Routes Events to Subscribers with matching topic.
+// Drains up to kReactorBatch events per wakeup and routes them together.
+void EventBus::reactor_loop(Shard& sh) {
+    std::vector<Event> batch(kReactorBatch);
+    while(run_.load(std::memory_order_relaxed)){
+        sh.bell.wait([this, &sh]{
+            return !sh.ingress->empty() || !run_.load(std::memory_order_relaxed);
+        }, reactor_wait_);
+        const size_t n = pop_batch(sh, batch);
+        if(n) route_batch(sh, batch.data(), n);
+    }
+    while(const size_t n = pop_batch(sh, batch)){
 #ifdef BUS_DEBUG
-        log_debug("[REACTOR-DRAIN] seq={} topic={}",
-                   ev.h.seq,
-                   static_cast<int>(ev.h.topic));
+        log_debug("[REACTOR-DRAIN] {} events, first seq={} topic={}",
+                   n,
+                   batch[0].h.seq,
+                   static_cast<int>(batch[0].h.topic));
 #endif
 
 // ingress is usually empty because the while(run) loop fans out every event 
 //before stop() is called that bit flips run ! Hence you will not see the
 //print statement REACTOR-DRAIN on console 
-        std::scoped_lock lk(mu_);
-        for(auto &kv : subs_){
-            auto &slot = kv.second;
-            if(slot->t == ev.h.topic) slot->q->push(ev);
+        route_batch(sh, batch.data(), n);
+    }
+}
+
+size_t EventBus::pop_batch(Shard& sh, std::vector<Event>& batch) {
+    size_t n = 0;
+    while(n < batch.size() && sh.ingress->try_pop(batch[n])){
+        const Event& ev = batch[n];
+        if (reactor_trace_.load(std::memory_order_relaxed)) {
+            md::log_debug("[REACTOR] seq={} topic={}", ev.h.seq, (int)ev.h.topic);
         }
-        for(auto &kv : all_subs_){
-            auto &slot = kv.second;
-            slot->q->push(ev);
+        ++n;
+    }
+    return n;
+}
+
+void EventBus::route_batch(Shard& sh, Event* evs, size_t n) {
+    ingress_popped_.fetch_add(n, std::memory_order_relaxed);
+    sh.routed.fetch_add(n, std::memory_order_relaxed);
+    std::array<uint64_t, kTopicCount> counts{};
+    for(size_t i = 0; i < n; ++i){
+        auto idx = static_cast<size_t>(evs[i].h.topic);
+        if(idx < kTopicCount) ++counts[idx];
+    }
+    for(size_t i = 0; i < kTopicCount; ++i){
+        if(counts[i]) topic_counts_[i].fetch_add(counts[i], std::memory_order_relaxed);
+    }
+
+    if(bcast_){
+        // one write per event for all readers; blocks while the slowest
+        // reader is a lap behind. Parked readers only move once rung, so
+        // ring while waiting, not just after the batch. Once stopping, give
+        // up if the slowest reader stops making progress (stop() would
+        // otherwise hang joining us).
+        uint64_t last_min = 0;
+        int stalled = 0;
+        auto on_full = [&](uint64_t min_seq){
+            bcast_bell_.ring();
+            if(min_seq != last_min){ last_min = min_seq; stalled = 0; return true; }
+            return run_.load(std::memory_order_relaxed) || ++stalled < kStopStallYields;
+        };
+        size_t i = 0;
+        for(; i < n; ++i){
+            if(!bcast_->publish(std::move(evs[i]), on_full)) break;
+        }
+        bcast_bell_.ring();
+        if(i < n){
+            log_warn("EventBus: stopping, dropped {} broadcast events behind a stalled reader", n - i);
         }
+        return;
     }
+
+    // refresh our snapshot only when the control plane changed something
+    const uint64_t v = routes_version_.load(std::memory_order_acquire);
+    if(v != sh.reactor_routes_version){
+        sh.reactor_routes = std::atomic_load_explicit(&sh.routes, std::memory_order_acquire);
+        sh.reactor_routes_version = v;
+    }
+    const RouteTable& rt = *sh.reactor_routes;
+    for(size_t i = 0; i < n; ++i){
+        // filters first, so an event nobody wants is never copied
+        sh.targets.clear();
+        for_each_route(rt, evs[i], [&sh](const std::shared_ptr<SubSlot>& slot){
+            sh.targets.push_back(&slot);
+        });
+        if(sh.targets.empty()) continue;
+        // shared_events: one envelope per routed event, subscribers get refs
+        EventRef ref;
+        if(sh.event_pool) ref = sh.event_pool->make(std::move(evs[i]));
+        const Event& ev = ref ? *ref : evs[i];
+        for(auto* slot : sh.targets) enqueue(sh, *slot, ev, ref);
+    }
+
+    // one wake-up per subscriber per batch instead of per event
+    for(auto &slot : sh.notify_list){
+        slot->notify_pending[sh.index] = 0;
+        note_depth(*slot);
+        notify(slot);
+    }
+    sh.notify_list.clear();
 }
 
+// what happens on a full queue is the subscription's OverflowPolicy;
+// only Block makes the reactor wait
+// reactor only: hand item to one subscriber according to its overflow
+// policy; false if nothing was queued
+template <typename Item>
+bool EventBus::enqueue_into(const std::shared_ptr<SubSlot>& s, SpscRing<Item>* q,
+                            BoundedQueue<Item>* lq, const Item& item) {
+    switch(s->opts.overflow){
+        case OverflowPolicy::Block:
+            if(!q->try_push(item)){
+                notify(s); // it may be parked on events we have not rung for yet
+                while(!q->try_push(item)){
+                    if(!s->run.load(std::memory_order_relaxed)) return false;
+                    std::this_thread::yield();
+                }
+            }
+            break;
+        case OverflowPolicy::DropNewest:
+            if(!q->try_push(item)){
+                s->dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            break;
+        case OverflowPolicy::DropOldest:
+            if(lq->push_evict_oldest(item)) s->dropped.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case OverflowPolicy::Conflate:
+            break; // goes through cq, see enqueue()
+    }
+    return true;
+}
+
+void EventBus::enqueue(Shard& sh, const std::shared_ptr<SubSlot>& s, const Event& ev, const EventRef& ref) {
+    bool queued = true;
+    if(s->cq){
+        if(s->cq->push(ev) != ConflatingQueue::PushResult::Queued){
+            s->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }else if(ref){
+        queued = enqueue_into(s, s->rq.empty() ? nullptr : s->rq[sh.index].get(), s->rlq.get(), ref);
+    }else{
+        queued = enqueue_into(s, s->q.empty() ? nullptr : s->q[sh.index].get(), s->lq.get(), ev);
+    }
+    if(queued && !s->notify_pending[sh.index]){
+        s->notify_pending[sh.index] = 1;
+        sh.notify_list.push_back(s);
+    }
+}
+
+// reactor: queue depth right after a batch is about as deep as it gets
+void EventBus::note_depth(SubSlot& s) {
+    const uint64_t d = s.depth();
+    uint64_t hwm = s.depth_hwm.load(std::memory_order_relaxed);
+    while(d > hwm && !s.depth_hwm.compare_exchange_weak(hwm, d, std::memory_order_relaxed)){}
+}
+
+void EventBus::notify(const std::shared_ptr<SubSlot>& s) {
+    if(pool_) pool_->schedule(s);
+    else s->bell.ring();
+}
 
 void EventBus::stop(){
     if(!run_.exchange(false))return;
-    ingress_->push(Event{}); // wake up reactor if waiting 
-    //because pop is blocking in reactor if nothing comes in ingress queue 
-    //then it will stay blocked forever
+    // control goes out of band: the flag plus a ring, never through ingress,
+    // so no data path has to test for (or can be mistaken for) a sentinel.
+    // Parked reactors re-check run_ on the ring, then drain what is left.
+    for(auto &sh : shards_) sh->bell.ring();
 
     log_info("EventBus stopping...");
 
-    if(reactor_.joinable())reactor_.join();
+    for(auto &sh : shards_){
+        if(sh->th.joinable()) sh->th.join();
+        sh->reactor_routes.reset();
+    }
 
     std::vector<SubId> ids;
     {
@@ -276,6 +740,7 @@ void EventBus::stop(){
         for(auto &kv : all_subs_) ids.push_back(kv.first);
     }
     for(auto id : ids) unsubscribe(id);
+    if(pool_) pool_->stop();
 
     if (perf_enabled_.load(std::memory_order_relaxed)) {
         perf_end_ns_ = md::now_ns();
@@ -286,17 +751,19 @@ void EventBus::print_stats() const {
     log_info("EventBus stats:");
     log_info("  published        = {}", published_.load(std::memory_order_relaxed));
     log_info("  ingress_popped   = {}", ingress_popped_.load(std::memory_order_relaxed));
+    log_info("  ingress_full     = {}", ingress_full_.load(std::memory_order_relaxed));
+    log_info("  payload_mismatch = {}", payload_mismatch());
 
     auto load_topic = [&](Topic t) -> uint64_t {
         auto idx = static_cast<size_t>(t);
-        if (idx >= kMaxTopics) return 0;
+        if (idx >= kTopicCount) return 0;
         return topic_counts_[idx].load(std::memory_order_relaxed);
     };
 
-    log_info("  topic[MD_TICK]   = {}", load_topic(Topic::MD_TICK));
-    log_info("  topic[LOG]       = {}", load_topic(Topic::LOG));
-    log_info("  topic[HEARTBEAT] = {}", load_topic(Topic::HEARTBEAT));
-    log_info("  topic[BAR_1S]    = {}", load_topic(Topic::BAR_1S));
+    for(size_t i = 0; i < kTopicCount; ++i){
+        const auto t = static_cast<Topic>(i);
+        log_info("  {:<19}= {}", fmt::format("topic[{}]", to_string(t)), load_topic(t));
+    }
 
     auto p = perf_snapshot();
     md::log_info("Perf:");
@@ -305,7 +772,100 @@ void EventBus::print_stats() const {
     md::log_info("  events/sec   = {}", p.eps);
     md::log_info("  latency(ns)  min={} avg={} p50~{} p95~{} p99~{} max={}",
                 p.lat_min, p.lat_avg, p.lat_p50, p.lat_p95, p.lat_p99, p.lat_max);
+    md::log_info("  dropped      = {}", p.dropped);
+    md::log_info("  wait         reactor={} workers={}", to_string(p.reactor_wait), to_string(p.worker_wait));
+    for(const auto& t : p.topics){
+        md::log_info("  topic[{}] routed={} lat p50~{} p99~{} max={} cb p50~{} p99~{} max={}",
+                     to_string(t.topic), t.routed, t.latency.p50, t.latency.p99, t.latency.max,
+                     t.callback.p50, t.callback.p99, t.callback.max);
+    }
+    for(const auto& u : p.subscribers){
+        md::log_info("  sub[{}] {} ({}) delivered={} dropped={} depth={} hwm={} lat p50~{} p99~{} max={} cb p50~{} p99~{} max={}",
+                     u.id, u.name, u.all ? std::string("ALL") : to_string(u.topic),
+                     u.delivered, u.dropped, u.depth, u.depth_hwm,
+                     u.latency.p50, u.latency.p99, u.latency.max,
+                     u.callback.p50, u.callback.p99, u.callback.max);
+    }
+    for(size_t i = 0; i < event_pools_.size(); ++i){
+        md::log_info("  envelopes    shard[{}] = {}", i, event_pools_[i]->allocated());
+    }
+    if(shards_.size() > 1){
+        for(size_t i = 0; i < p.shard_routed.size(); ++i){
+            md::log_info("  shard[{}]     routed = {}", i, p.shard_routed[i]);
+        }
+    }
+    {
+        std::scoped_lock lk(mu_);
+        for(const auto* m : {&subs_, &all_subs_}){
+            for(const auto& kv : *m){
+                if(kv.second->wait != p.worker_wait){
+                    md::log_info("  sub[{}] {} wait={}", kv.first, kv.second->opts.name, to_string(kv.second->wait));
+                }
+            }
+        }
+    }
+
+}
 
+SubscriberStats EventBus::sub_stats(const SubSlot& s) const {
+    SubscriberStats u;
+    u.id = s.id;
+    u.name = s.opts.name;
+    u.topic = s.t;
+    u.all = s.all;
+    u.delivered = s.delivered.load(std::memory_order_relaxed);
+    u.dropped = s.dropped.load(std::memory_order_relaxed);
+    if(s.cursor){
+        const uint64_t next = s.cursor->next.load(std::memory_order_relaxed);
+        const uint64_t pub = bcast_->published();
+        u.depth = pub > next ? pub - next : 0;
+    }else{
+        u.depth = s.depth();
+    }
+    u.depth_hwm = std::max<uint64_t>(u.depth, s.depth_hwm.load(std::memory_order_relaxed));
+    LatencyHistogram lat, cb;
+    s.hist.lat.merge_into(lat);
+    s.hist.cb.merge_into(cb);
+    u.latency = summarize(lat);
+    u.callback = summarize(cb);
+    return u;
+}
+
+// merge one slot's histograms into bus-wide / per-topic totals
+void EventBus::fold_perf(const SubSlot& s, PerfTotals& into) const {
+    into.delivered += s.delivered.load(std::memory_order_relaxed);
+    s.hist.lat.merge_into(into.lat);
+    if(s.all){
+        for(size_t i = 0; i < kTopicCount; ++i){
+            const auto* th = s.topic_hist[i].load(std::memory_order_acquire);
+            if(!th) continue;
+            th->lat.merge_into(into.topic_lat[i]);
+            th->cb.merge_into(into.topic_cb[i]);
+        }
+    }else{
+        const auto idx = static_cast<size_t>(s.t);
+        if(idx < kTopicCount){
+            s.hist.lat.merge_into(into.topic_lat[idx]);
+            s.hist.cb.merge_into(into.topic_cb[idx]);
+        }
+    }
+}
+
+bool EventBus::pin_reactor(int cpu, size_t shard){
+    if(shard >= shards_.size()) return false;
+    auto& th = shards_[shard]->th;
+    return th.joinable() && pin_thread(th.native_handle(), cpu);
+}
+
+bool EventBus::pin_subscription(SubId id, int cpu){
+    std::scoped_lock lk(mu_);
+    auto it = subs_.find(id);
+    if(it == subs_.end()){
+        it = all_subs_.find(id);
+        if(it == all_subs_.end()) return false;
+    }
+    auto& th = it->second->worker;
+    return th.joinable() && pin_thread(th.native_handle(), cpu);
 }
 
 PerfSnapshot EventBus::perf_snapshot() const {
@@ -314,23 +874,100 @@ PerfSnapshot EventBus::perf_snapshot() const {
     const uint64_t start = perf_start_ns_;
     const uint64_t end   = perf_end_ns_ ? perf_end_ns_ : md::now_ns();
 
-    std::scoped_lock lk(perf_mu_);
+    s.reactor_wait = reactor_wait_;
+    s.worker_wait = worker_wait_;
+    for(const auto &sh : shards_) s.shard_routed.push_back(sh->routed.load(std::memory_order_relaxed));
+
+    // merge every live slot's histograms on top of what retired ones left
+    std::scoped_lock lk(mu_);
+    PerfTotals tot = retired_perf_;
+    s.dropped = dropped_retired_.load(std::memory_order_relaxed);
+    auto collect = [this, &s, &tot](const auto& m){
+        for(const auto& kv : m){
+            const uint64_t d = kv.second->dropped.load(std::memory_order_relaxed);
+            s.dropped += d;
+            if(d) s.drops.push_back(SubscriberDrops{kv.first, kv.second->opts.name, d});
+            s.subscribers.push_back(sub_stats(*kv.second));
+            fold_perf(*kv.second, tot);
+        }
+    };
+    collect(subs_);
+    collect(all_subs_);
+    std::sort(s.subscribers.begin(), s.subscribers.end(),
+              [](const auto& a, const auto& b){ return a.id < b.id; });
 
-    s.events = latency_ns_hist_.n;
+    s.events = tot.delivered;
     s.duration_ns = (end >= start) ? (end - start) : 0;
     if (s.duration_ns > 0) {
         long double eps_ld = (long double)s.events * 1e9L / (long double)s.duration_ns;
         s.eps = (uint64_t)eps_ld;
     }
 
-    s.lat_min = (latency_ns_hist_.n ? latency_ns_hist_.min_v : 0);
-    s.lat_avg = latency_ns_hist_.avg();
-    s.lat_p50 = latency_ns_hist_.percentile(0.50);
-    s.lat_p95 = latency_ns_hist_.percentile(0.95);
-    s.lat_p99 = latency_ns_hist_.percentile(0.99);
-    s.lat_max = latency_ns_hist_.max_v;
+    s.lat_min = (tot.lat.n ? tot.lat.min_v : 0);
+    s.lat_avg = tot.lat.avg();
+    s.lat_p50 = tot.lat.percentile(0.50);
+    s.lat_p95 = tot.lat.percentile(0.95);
+    s.lat_p99 = tot.lat.percentile(0.99);
+    s.lat_max = tot.lat.max_v;
+
+    for(size_t i = 0; i < kTopicCount; ++i){
+        const uint64_t routed = topic_counts_[i].load(std::memory_order_relaxed);
+        if(!routed && !tot.topic_lat[i].n) continue;
+        s.topics.push_back(TopicStats{
+            .topic = static_cast<Topic>(i),
+            .routed = routed,
+            .latency = summarize(tot.topic_lat[i]),
+            .callback = summarize(tot.topic_cb[i]),
+        });
+    }
 
     return s;
 }
 
+void EventBus::collect_metrics(MetricSet& out) const {
+    out.counter("md_bus_published_total", (double)published_.load(std::memory_order_relaxed));
+    out.counter("md_bus_ingress_popped_total", (double)ingress_popped_.load(std::memory_order_relaxed));
+    out.counter("md_bus_ingress_full_total", (double)ingress_full_.load(std::memory_order_relaxed));
+    out.counter("md_bus_payload_mismatch_total", (double)payload_mismatch());
+
+    for(const auto& sh : shards_){
+        const MetricLabels l{{"shard", std::to_string(sh->index)}};
+        out.counter("md_bus_shard_routed_total", (double)sh->routed.load(std::memory_order_relaxed), l);
+        if(sh->ingress) out.gauge("md_bus_ingress_depth", (double)sh->ingress->size(), l);
+    }
+    for(size_t i = 0; i < event_pools_.size(); ++i){
+        out.gauge("md_bus_event_envelopes", (double)event_pools_[i]->allocated(),
+                  {{"shard", std::to_string(i)}});
+    }
+    if(pool_){
+        out.counter("md_bus_pool_runs_total", (double)pool_->runs());
+        out.counter("md_bus_pool_steals_total", (double)pool_->steals());
+    }
+
+    const PerfSnapshot s = perf_snapshot();
+    out.counter("md_bus_delivered_total", (double)s.events);
+    out.counter("md_bus_dropped_total", (double)s.dropped);
+    out.latency("md_bus_latency_ns", LatencySummary{
+        .count = s.events, .min = s.lat_min, .avg = s.lat_avg,
+        .p50 = s.lat_p50, .p95 = s.lat_p95, .p99 = s.lat_p99, .max = s.lat_max});
+
+    for(const auto& t : s.topics){
+        const MetricLabels l{{"topic", to_string(t.topic)}};
+        out.counter("md_bus_topic_routed_total", (double)t.routed, l);
+        out.latency("md_bus_topic_latency_ns", t.latency, l);
+        out.latency("md_bus_topic_callback_ns", t.callback, l);
+    }
+
+    for(const auto& sub : s.subscribers){
+        const MetricLabels l{{"sub", std::to_string(sub.id)}, {"name", sub.name}};
+        out.counter("md_bus_sub_delivered_total", (double)sub.delivered, l);
+        out.counter("md_bus_sub_dropped_total", (double)sub.dropped, l);
+        out.gauge("md_bus_sub_queue_depth", (double)sub.depth, l);
+        out.gauge("md_bus_sub_queue_depth_hwm", (double)sub.depth_hwm, l);
+        out.latency("md_bus_sub_latency_ns", sub.latency, l);
+        out.latency("md_bus_sub_callback_ns", sub.callback, l);
+    }
+}
+
+
 }
\ No newline at end of file
@@ -1,16 +1,29 @@
 #pragma once
 #include<atomic>
+#include<deque>
 #include<functional>
 #include<memory>
+#include<optional>
 #include<string>
 #include<thread>
+#include<type_traits>
 #include <mutex>
 #include<unordered_map>
 #include<vector>
 
 #include "../common/bounded_queue.hpp"
+#include "../common/broadcast_ring.hpp"
+#include "../common/conflating_queue.hpp"
 #include "../common/event.hpp"
+#include "../common/event_filter.hpp"
+#include "../common/event_pool.hpp"
 #include "../common/metrics.hpp"
+#include "../common/metrics_export.hpp"
+#include "../common/mpsc_ring.hpp"
+#include "../common/spsc_ring.hpp"
+#include "../common/thread_util.hpp"
+#include "../common/wait.hpp"
+#include "worker_pool.hpp"
 
 
 namespace md {
@@ -18,27 +31,338 @@ namespace md {
 using Callback = std::function<void(const Event&)>;
 using SubId = uint64_t;
 
+// how the reactor hands events to subscribers
+//  Queues    : copy each event into every matching subscriber's own ring
+//  Broadcast : write each event once into a shared sequenced ring, every
+//              subscriber reads it in place through its own cursor and the
+//              reactor is gated by the slowest cursor
+enum class FanoutMode : uint8_t { Queues = 0, Broadcast = 1 };
+
+inline const char* to_string(FanoutMode m) {
+    switch (m) {
+        case FanoutMode::Queues : return "QUEUES";
+        case FanoutMode::Broadcast : return "BROADCAST";
+    }
+    return "UNKNOWN";
+}
+
+// who runs the callbacks
+//  Threaded : reactor thread(s) route, subscriber threads / pool run callbacks
+//  Inline   : no threads at all. publish() routes and runs every matching
+//             callback on the caller's thread, in subscription order, before
+//             it returns; publishes made from inside a callback are queued
+//             and run (FIFO) before the outermost publish returns. Meant for
+//             single-threaded backtests: deterministic and no hops.
+//             Queue options (overflow, capacity, shards, wait...) don't apply.
+enum class ExecMode : uint8_t { Threaded = 0, Inline = 1 };
+
+inline const char* to_string(ExecMode m) {
+    switch (m) {
+        case ExecMode::Threaded : return "THREADED";
+        case ExecMode::Inline : return "INLINE";
+    }
+    return "UNKNOWN";
+}
+
+struct BusOptions {
+    size_t ingress_cap = 65536;
+    // per subscriber ring, or the shared ring in Broadcast. Rings are
+    // preallocated: each slot is a full Event (~104 bytes, an EventRef with
+    // shared_events), and Queues mode keeps one ring per subscriber per
+    // shard it is attached to. 4096 is ~400KB per ring; raise it (or
+    // SubOptions::capacity for one hot subscriber) for bursty feeds.
+    size_t per_sub_cap = 4096;
+    FanoutMode fanout = FanoutMode::Queues;
+    ExecMode exec = ExecMode::Threaded;
+
+    // 0: one dedicated thread per subscription (classic model).
+    // N: subscriptions become strands on a fixed pool of N workers.
+    // Broadcast readers always get their own thread.
+    size_t worker_threads = 0;
+    bool pin_workers = false;          // worker i -> cpu i % hw_threads()
+    std::vector<int> worker_cpus;      // explicit cpus for the pool, wins over pin_workers
+    int worker_fifo_priority = 0;      // > 0: SCHED_FIFO for pool workers
+
+    // name / cpu / SCHED_FIFO for the reactor thread
+    ThreadConfig reactor_thread{.name = "md-reactor"};
+
+    // Queues only: N reactor threads, each with its own ingress ring.
+    // Events go to a shard by hashing their symbol (shard_of), so all
+    // events of one symbol keep publish order; events without a symbol
+    // (LOG, HEARTBEAT) go to shard 0. Broadcast always runs one reactor.
+    size_t reactor_shards = 1;
+    std::vector<int> shard_cpus;       // shard i -> shard_cpus[i % size], wins over reactor_thread.cpu
+
+    // Queues only: the reactor moves each event once into a pooled,
+    // ref-counted envelope and subscriber queues carry refs to it instead
+    // of their own copy. Callbacks get a const Event& into that shared
+    // storage. conflate_by_symbol subscriptions still keep copies.
+    bool shared_events = false;
+
+    // latency instrumentation: time 1 in perf_sample_every deliveries
+    uint32_t perf_sample_every = 1;
+
+    // how the reactor waits on ingress, and the default for subscription
+    // threads / pool workers (see WaitStrategy in wait.hpp)
+    WaitStrategy reactor_wait = WaitStrategy::SpinPark;
+    WaitStrategy worker_wait = WaitStrategy::SpinPark;
+};
+
+// what the reactor does when a subscriber's queue is full
+//  Block      : wait for the subscriber to make room (stalls everyone behind it)
+//  DropNewest : discard the incoming event
+//  DropOldest : discard the oldest queued event to make room
+//  Conflate   : replace the newest queued event with the same (topic,
+//               symbol), so the latest value per key survives; events
+//               with no queued match (other symbols, LOG, ...) are dropped.
+//               Queues in order while there is room (conflate_by_symbol
+//               conflates always).
+// Broadcast mode has no per-subscriber queue; readers always gate the reactor.
+enum class OverflowPolicy : uint8_t { Block = 0, DropNewest = 1, DropOldest = 2, Conflate = 3 };
+
+inline const char* to_string(OverflowPolicy p) {
+    switch (p) {
+        case OverflowPolicy::Block : return "BLOCK";
+        case OverflowPolicy::DropNewest : return "DROP_NEWEST";
+        case OverflowPolicy::DropOldest : return "DROP_OLDEST";
+        case OverflowPolicy::Conflate : return "CONFLATE";
+    }
+    return "UNKNOWN";
+}
+
+struct SubOptions {
+    OverflowPolicy overflow = OverflowPolicy::Block;
+    size_t capacity = 0;   // 0: BusOptions::per_sub_cap
+    std::string name;      // shows up in stats
+
+    // latest-value delivery: keep one pending event per (topic, symbol),
+    // newer ones overwrite older undelivered ones. overflow is ignored.
+    bool conflate_by_symbol = false;
+
+    // overrides BusOptions::worker_wait for this subscription's own thread;
+    // ignored with a worker pool (workers are shared)
+    std::optional<WaitStrategy> wait;
+
+    // name / cpu / SCHED_FIFO for this subscription's own thread, same
+    // caveat as above. Unnamed threads are called sub-<name or id>.
+    ThreadConfig thread;
+
+    // sharded bus: only take events from these reactor shards (empty: all)
+    std::vector<size_t> shards;
+
+    // drop unwanted events in the reactor, before they are queued (see
+    // EventFilter). Broadcast mode has no per-subscriber queue: there the
+    // subscriber's own thread skips them.
+    EventFilter filter;
+};
+
 class EventBus {
 private:
-    struct SubSlot {
+    // reactor is the only producer and the worker the only consumer of q,
+    // so a lock-free SPSC ring is enough; bell parks the worker when idle.
+    // With a worker pool the slot is a Strand instead: no thread of its own,
+    // whichever pool worker runs it is the (single) consumer.
+    // DropOldest/Conflate need the producer to touch queued items, so those
+    // subscriptions use a locked BoundedQueue (lq) instead of the ring, and
+    // Conflate / conflate_by_symbol a ConflatingQueue (cq, always copies).
+    // With shared_events the ring
+    // and the locked queue hold EventRefs (rq/rlq) instead of copies.
+    // With several reactor shards each shard gets its own SPSC lane in q/rq
+    // (indexed by shard, null if not attached); the locked queues are
+    // shared by all shards.
+    struct SubSlot final : Strand {
+        EventBus* bus{nullptr};
+        SubId id{0};
         Topic t {Topic::MD_TICK};
-        std::unique_ptr<BoundedQueue<Event>> q;
+        bool all{false};
+        SubOptions opts;
+        WaitStrategy wait{WaitStrategy::SpinPark}; // resolved from opts / BusOptions
+        std::vector<std::unique_ptr<SpscRing<Event>>> q;        // Queues: Block, DropNewest
+        std::unique_ptr<BoundedQueue<Event>> lq;                // Queues: DropOldest
+        std::unique_ptr<ConflatingQueue> cq;                    // Queues: Conflate, conflate_by_symbol
+        std::vector<std::unique_ptr<SpscRing<EventRef>>> rq;    // shared_events: Block, DropNewest
+        std::unique_ptr<BoundedQueue<EventRef>> rlq;            // shared_events: DropOldest
+        std::shared_ptr<BroadcastRing<Event>::Cursor> cursor;   // Broadcast
+        std::atomic<uint64_t> dropped{0};                       // reactor writes
+        std::atomic<uint64_t> depth_hwm{0};                     // reactor writes, once per batch
+        std::atomic<uint64_t> delivered{0};                     // consumer writes
+        Doorbell bell;
         std::thread worker;
         std::atomic<bool>run{true};
+        std::atomic<bool>retired{false}; // pool: final drain done
+        std::vector<uint8_t> shards;         // attached to shard i
+        std::vector<uint8_t> notify_pending; // per shard, that reactor only: pushed this batch, not rung yet
+        bool field_filter{false};            // opts.filter has more than symbols to check
         Callback cb;
+
+        // consumer writes (plain stores), perf_snapshot() merges
+        struct Hists {
+            SingleWriterHistogram<> lat;   // publish -> callback start
+            SingleWriterHistogram<> cb;    // callback duration
+        };
+        Hists hist;
+        // subscribe_all only: the same split by topic, allocated by the
+        // consumer the first time it sees a topic
+        std::array<std::atomic<Hists*>, kTopicCount> topic_hist{};
+        uint32_t sample_ctr{0};               // consumer only
+
+        ~SubSlot() override {
+            for(auto& h : topic_hist) delete h.load(std::memory_order_relaxed);
+        }
+
+        // consumer side
+        Event scratch;   // popped copies land here
+        EventRef ref;    // popped shared event, held for the callback only
+        size_t lane{0};  // next lane to look at, rotates so no shard starves
+
+        template <typename Item>
+        bool pop_lanes(std::vector<std::unique_ptr<SpscRing<Item>>>& lanes, Item& out) {
+            const size_t n = lanes.size();
+            for(size_t k = 0; k < n; ++k){
+                const size_t i = (lane + k) % n;
+                if(lanes[i] && lanes[i]->try_pop(out)){
+                    lane = i + 1 == n ? 0 : i + 1;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // pop one event from whichever queue this slot uses and deliver it
+        bool deliver_next() {
+            if(!rq.empty() || rlq){
+                if(!(rlq ? rlq->try_pop(ref) : pop_lanes(rq, ref))) return false;
+                bus->deliver(*this, *ref);
+                ref = EventRef{};
+                return true;
+            }
+            if(!(lq ? lq->try_pop(scratch) : cq ? cq->try_pop(scratch) : pop_lanes(q, scratch))) return false;
+            bus->deliver(*this, scratch);
+            return true;
+        }
+        // approximate, any thread
+        size_t depth() const {
+            size_t d = 0;
+            if(lq) d += lq->size();
+            if(rlq) d += rlq->size();
+            if(cq) d += cq->size();
+            for(const auto& l : q) if(l) d += l->size();
+            for(const auto& l : rq) if(l) d += l->size();
+            return d;
+        }
+        bool empty() const {
+            if(lq) return lq->empty();
+            if(rlq) return rlq->empty();
+            if(cq) return cq->empty();
+            for(const auto& l : q) if(l && !l->empty()) return false;
+            for(const auto& l : rq) if(l && !l->empty()) return false;
+            return true;
+        }
+
+        StrandState execute(size_t budget) override { return bus->drain(*this, budget); }
+        bool has_work() const override {
+            return !empty() || !run.load(std::memory_order_seq_cst);
+        }
+    };
+
+    // immutable routing snapshot: subscriber lists indexed by topic, one per
+    // reactor shard (only the slots attached to it). Rebuilt under mu_ on every subscribe/unsubscribe and swapped in; the
+    // reactor never takes mu_, it only re-reads the snapshot when
+    // routes_version_ moves. shared_ptr keeps an unlinked slot alive for as
+    // long as an old snapshot can still point at it.
+    // Subscriptions filtered by symbol sit in by_symbol / all_by_symbol
+    // under each of their symbols instead, so an event is only looked at by
+    // subscribers of its symbol. Those are flat, indexed by SymbolId and
+    // sized to the largest filtered id. Every list is sorted by subscription id.
+    using SlotList = std::vector<std::shared_ptr<SubSlot>>;
+    struct RouteTable {
+        std::array<SlotList, kTopicCount> by_topic;
+        SlotList all;
+        std::array<std::vector<SlotList>, kTopicCount> by_symbol;
+        std::vector<SlotList> all_by_symbol;
+        bool indexed{false}; // any symbol-filtered subscription at all
+    };
+
+    // one reactor: its own ingress ring, thread and routing state
+    struct Shard {
+        size_t index{0};
+        std::unique_ptr<MpscRing<Event>> ingress;
+        Doorbell bell;
+        std::thread th;
+        std::shared_ptr<const RouteTable> routes;  // atomic_load/atomic_store only
+        std::atomic<uint64_t> routed{0};
+
+        // this shard's reactor thread only: its current snapshot, and the
+        // slots that got events in the current batch (rung once at the end)
+        std::shared_ptr<const RouteTable> reactor_routes;
+        uint64_t reactor_routes_version{~0ULL};
+        std::vector<std::shared_ptr<SubSlot>> notify_list;
+        std::vector<const std::shared_ptr<SubSlot>*> targets; // subscribers of the event being routed
+        EventPool* event_pool{nullptr};
     };
 
-    void reactor_loop();
+    void reactor_loop(Shard& sh);
+    SubId add_sub(Topic t, bool all, Callback cb, const SubOptions& opts);
+    void worker_loop(SubSlot* s);
+    void reader_loop(SubSlot* s);
+    Doorbell& bell_of(SubSlot& s) { return bcast_ ? bcast_bell_ : s.bell; }
+    void deliver(SubSlot& s, const Event& ev);
+    StrandState drain(SubSlot& s, size_t budget);
+    void retire_slot(SubSlot& s);
+    void enqueue(Shard& sh, const std::shared_ptr<SubSlot>& s, const Event& ev, const EventRef& ref);
+    template <typename Item>
+    bool enqueue_into(const std::shared_ptr<SubSlot>& s, SpscRing<Item>* q,
+                      BoundedQueue<Item>* lq, const Item& item);
+    void notify(const std::shared_ptr<SubSlot>& s);
+    template <typename F>
+    static void for_each_route(const RouteTable& rt, const Event& ev, F&& f);
+    void note_depth(SubSlot& s);
+    SubscriberStats sub_stats(const SubSlot& s) const;
+    size_t pop_batch(Shard& sh, std::vector<Event>& batch);
+    void route_batch(Shard& sh, Event* evs, size_t n);
+    bool push_ingress(Event&& e);
+    bool push_ingress_batch(Event* first, size_t n);
+    bool push_shard_batch(Shard& sh, Event* first, size_t n);
+    bool dispatch_inline(Event* first, size_t n);
+    void route_inline(const Event& ev);
+    void stamp_batch(Event* first, size_t n, bool preserve_ts);
+
+    // shared_events only, one per shard; declared before anything that can
+    // hold an EventRef
+    std::vector<std::unique_ptr<EventPool>> event_pools_;
 
-    std::unique_ptr<BoundedQueue<Event>> ingress_; //producer - > reactor
-    std::thread reactor_;
+    // producers (feed handlers, BarBuilder, OrderRouter, strategies...) -> reactor(s)
+    std::vector<std::unique_ptr<Shard>> shards_;
     std::atomic<bool> run_{true};
 
-    // rounting and bookkeeping (for subscriptions)
-    std::mutex mu_;
-    std::unordered_map<SubId, std::unique_ptr<SubSlot>> subs_;
-    std::unordered_map<SubId, std::unique_ptr<SubSlot>> all_subs_;
+    // rounting and bookkeeping (for subscriptions), control plane only
+    mutable std::mutex mu_;
+    std::unordered_map<SubId, std::shared_ptr<SubSlot>> subs_;
+    std::unordered_map<SubId, std::shared_ptr<SubSlot>> all_subs_;
+    std::atomic<uint64_t> routes_version_{0};  // bumped after every shard got its new table
+    void rebuild_routes_locked();
+
+    // max events the reactor pops per wakeup and routes together
+    static constexpr size_t kReactorBatch = 256;
+    // Broadcast, once stopping: yields without reader progress before the
+    // reactor gives up on a full ring
+    static constexpr int kStopStallYields = 10000;
     const size_t per_sub_cap_;
+    const FanoutMode fanout_;
+    const WaitStrategy reactor_wait_;
+    const WaitStrategy worker_wait_;
+
+    // ExecMode::Inline only; publishing thread only
+    const bool inline_;
+    std::deque<Event> inline_q_;     // published, not dispatched yet
+    bool inline_busy_{false};        // a dispatch loop is running further up the stack
+
+    // null unless BusOptions::worker_threads > 0
+    std::unique_ptr<WorkerPool> pool_;
+
+    // Broadcast mode only: one shared ring, all readers park on one bell
+    std::unique_ptr<BroadcastRing<Event>> bcast_;
+    Doorbell bcast_bell_;
 
     // sequence + ids
     std::atomic<uint64_t> seq_{0};
@@ -46,9 +370,11 @@ private:
 
     std::atomic<uint64_t> published_{0};
     std::atomic<uint64_t> ingress_popped_{0};
+    std::atomic<uint64_t> ingress_full_{0};
+    std::atomic<uint64_t> dropped_retired_{0}; // drops of subscriptions already gone
+    std::atomic<uint64_t> payload_mismatch_{0}; // typed subscribers handed the wrong payload
 
-    static constexpr size_t kMaxTopics = 8;
-    std::array<std::atomic<uint64_t>, kMaxTopics> topic_counts_{0}; // array to keep 
+    std::array<std::atomic<uint64_t>, kTopicCount> topic_counts_{}; // array to keep 
     //track of the topic counts
 
     std::atomic<bool> perf_enabled_{true};
@@ -57,32 +383,102 @@ private:
     uint64_t perf_start_ns_ = 0;
     uint64_t perf_end_ns_   = 0;
 
-    mutable std::mutex perf_mu_;
-    Log2Histogram<48> latency_ns_hist_;
+    // latency is recorded per subscription without locks and merged in
+    // perf_snapshot(); this is what unsubscribed slots left behind (under mu_)
+    struct PerfTotals {
+        uint64_t delivered = 0;
+        LatencyHistogram lat;
+        std::array<LatencyHistogram, kTopicCount> topic_lat;
+        std::array<LatencyHistogram, kTopicCount> topic_cb;
+    };
+    PerfTotals retired_perf_;
+    void fold_perf(const SubSlot& s, PerfTotals& into) const;
+    std::atomic<uint32_t> perf_sample_every_{1};
 
 public:
-    explicit EventBus(size_t ingress_cap = 65536, size_t per_sub_cap = 65536);
+    explicit EventBus(size_t ingress_cap = 65536, size_t per_sub_cap = 4096);
+    explicit EventBus(const BusOptions& opts);
 
     ~EventBus();
 
     //declaration
     SubId subscribe(Topic T, Callback cb);
+    SubId subscribe(Topic T, Callback cb, const SubOptions& opts);
     SubId subscribe_all(Callback cb);
+    SubId subscribe_all(Callback cb, const SubOptions& opts);
+    // waits until the subscription's callback has run for the last time;
+    // with a worker pool, called from a callback (even for its own
+    // subscription), it returns at once and the strand retires on its own
     void unsubscribe(SubId id);
 
-    // (non blocking) enqueue in ingress_ and return
+    // enqueue in ingress_ and return; only waits if ingress_ is full
     bool publish(Event e);
     bool publish_preserve(Event e);
+    // never waits: returns false (event dropped) if ingress_ is full
+    bool try_publish(Event e);
+
+    // publish n events in one go: one seq_ reservation, one clock read and
+    // one ingress claim per chunk. Events are moved from; they get
+    // consecutive seq numbers in array order.
+    bool publish_batch(Event* first, size_t n);
+    bool publish_batch_preserve(Event* first, size_t n);
+
+    // typed: the payload type follows from the topic (TopicTraits), checked
+    // at compile time, e.g. bus.publish<Topic::MD_TICK>(Tick{...})
+    template <Topic T>
+    bool publish(payload_t<T> p) {
+        Header h{};
+        h.topic = T;
+        return publish(Event{.h = h, .p = std::move(p)});
+    }
+
+    // f(const P&) or f(const P&, const Event&) with P = payload_t<T>.
+    // Typed publishers can't get it wrong; an untyped publish(Event) with
+    // the wrong payload for T is skipped and counted (payload_mismatch).
+    template <Topic T, typename F>
+    SubId subscribe(F f, const SubOptions& opts = {}) {
+        using P = payload_t<T>;
+        return subscribe(T, [this, f = std::move(f)](const Event& e) mutable {
+            const P* p = std::get_if<P>(&e.p);
+            if(!p){
+                payload_mismatch_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if constexpr (std::is_invocable_v<F&, const P&, const Event&>) f(*p, e);
+            else f(*p);
+        }, opts);
+    }
+    uint64_t payload_mismatch() const { return payload_mismatch_.load(std::memory_order_relaxed); }
+
     void stop(); // gracefully shutdown
 
     void print_stats() const;
 
     PerfSnapshot perf_snapshot() const;
 
+    // counters, queue depths and latency as md_bus_* samples, for a
+    // MetricsRegistry source; same cost as perf_snapshot(), no hot-path work
+    void collect_metrics(MetricSet& out) const;
+
     void set_perf_enabled(bool on) {perf_enabled_.store(on, std::memory_order_relaxed);}
+
+    // time 1 in n deliveries per subscription (1: all of them). Counters
+    // like delivered/dropped stay exact; histogram counts become samples.
+    void set_perf_sampling(uint32_t every_n) {
+        perf_sample_every_.store(every_n ? every_n : 1, std::memory_order_relaxed);
+    }
     
     void set_reactor_trace(bool on) {reactor_trace_.store(on, std::memory_order_relaxed);}
 
+    // reactor shard an event is routed through (by symbol)
+    size_t shard_of(const Event& e) const;
+    size_t shard_count() const { return shards_.size(); }
+
+    // move running threads to another cpu after the fact; false if the
+    // subscription is unknown, runs on the pool, or pinning failed
+    bool pin_reactor(int cpu, size_t shard = 0);
+    bool pin_subscription(SubId id, int cpu);
+
 };
 }
 
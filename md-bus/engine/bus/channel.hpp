@@ -0,0 +1,229 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../common/event.hpp"
+#include "../common/log.hpp"
+#include "../common/mpsc_ring.hpp"
+#include "../common/thread_util.hpp"
+#include "../common/time.hpp"
+#include "../common/wait.hpp"
+
+namespace md {
+
+// one payload type, no variant: what a Channel<T> carries
+template <typename T>
+struct Typed {
+    Header h;
+    T v{};
+};
+
+struct ChannelOptions {
+    size_t capacity = 65536;                      // rounded up to a power of two by the ring
+    WaitStrategy wait = WaitStrategy::SpinPark;   // dispatcher idle strategy
+    ThreadConfig thread{.name = "md-chan"};
+};
+
+// Typed single-payload pub/sub for hot paths that don't need the bus's
+// routing: producers -> one MPSC ring of Typed<T> -> one dispatcher thread
+// that runs every subscriber in subscription order. No Payload variant is
+// built, stored or switched on; the topic stamped into the header is fixed
+// per channel (DefaultTopic<T> unless given).
+//
+//   Channel<Tick> ticks;
+//   ticks.subscribe([](const Tick& t){ ... });
+//   ticks.publish(Tick{.symbol = "NIFTY", .pq = 1.0, .qty = 1});
+//
+// Callbacks share the dispatcher thread, so a slow one delays the others.
+template <typename T>
+class Channel {
+public:
+    using SubId = uint64_t;
+    using Fn = std::function<void(const T&, const Header&)>;
+
+private:
+    struct Sub {
+        SubId id;
+        Fn fn;
+    };
+    using SubList = std::vector<Sub>;
+
+    const Topic topic_;
+    const ChannelOptions opts_;
+    MpscRing<Typed<T>> ring_;
+    Doorbell bell_;
+    std::atomic<bool> run_{true};
+    std::thread th_;
+
+    // copy-on-write subscriber list, swapped under mu_; the dispatcher only
+    // atomic_loads it
+    std::mutex mu_;
+    std::shared_ptr<const SubList> subs_ = std::make_shared<const SubList>();
+    SubId next_id_{1};
+
+    // odd while the dispatcher is inside a batch: unsubscribe() waits it out
+    std::atomic<uint64_t> dispatch_gen_{0};
+
+    // publish() calls past their run_ check: stop() lets them finish
+    // before the dispatcher's final drain, so nothing pushed is stranded
+    std::atomic<uint32_t> publishing_{0};
+
+    std::atomic<uint64_t> seq_{0};
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> full_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> dispatched_{0};
+
+    static constexpr size_t kBatch = 256;
+
+    Typed<T> stamp(T&& v) {
+        Typed<T> e;
+        e.h.seq = seq_.fetch_add(1, std::memory_order_relaxed);
+        e.h.topic = topic_;
+        e.h.ts_ns = now_ns();
+        e.h.t_pub_ns = e.h.ts_ns;
+        e.v = std::move(v);
+        return e;
+    }
+
+    // seq_cst pair with stop(): either it sees us in publishing_, or we see
+    // run_ down
+    bool enter() {
+        publishing_.fetch_add(1, std::memory_order_seq_cst);
+        if(run_.load(std::memory_order_seq_cst)) return true;
+        leave();
+        return false;
+    }
+    void leave() { publishing_.fetch_sub(1, std::memory_order_release); }
+
+    size_t dispatch_some(std::vector<Typed<T>>& batch) {
+        size_t n = 0;
+        while(n < batch.size() && ring_.try_pop(batch[n])) ++n;
+        if(n == 0) return 0;
+        // seq_cst with unsubscribe(): it either sees us inside the batch, or
+        // we see its new list
+        dispatch_gen_.fetch_add(1, std::memory_order_seq_cst);
+        const auto subs = std::atomic_load_explicit(&subs_, std::memory_order_seq_cst);
+        for(size_t i = 0; i < n; ++i){
+            for(const auto& s : *subs) s.fn(batch[i].v, batch[i].h);
+        }
+        dispatch_gen_.fetch_add(1, std::memory_order_release);
+        dispatched_.fetch_add(n, std::memory_order_relaxed);
+        return n;
+    }
+
+    void loop() {
+        apply_thread_config(opts_.thread);
+        std::vector<Typed<T>> batch(kBatch);
+        while(run_.load(std::memory_order_relaxed)){
+            bell_.wait([this]{
+                return !ring_.empty() || !run_.load(std::memory_order_relaxed);
+            }, opts_.wait);
+            dispatch_some(batch);
+        }
+        while(dispatch_some(batch)){}
+    }
+
+public:
+    explicit Channel(const ChannelOptions& opts = {})
+        : Channel(DefaultTopic<T>::value, opts) {}
+
+    Channel(Topic topic, const ChannelOptions& opts = {})
+        : topic_{topic}, opts_{opts}, ring_{opts.capacity} {
+        th_ = std::thread([this]{ loop(); });
+    }
+
+    ~Channel() { stop(); }
+
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    // f(const T&) or f(const T&, const Header&)
+    template <typename F>
+    SubId subscribe(F f) {
+        Fn fn;
+        if constexpr (std::is_invocable_v<F&, const T&, const Header&>) fn = std::move(f);
+        else fn = [f = std::move(f)](const T& v, const Header&) mutable { f(v); };
+        std::scoped_lock lk(mu_);
+        auto next = std::make_shared<SubList>(*subs_);
+        const SubId id = next_id_++;
+        next->push_back(Sub{id, std::move(fn)});
+        std::atomic_store_explicit(&subs_, std::shared_ptr<const SubList>(std::move(next)),
+                                   std::memory_order_release);
+        return id;
+    }
+
+    // after return the callback won't run again (unless called from inside
+    // a callback, where the current batch still finishes)
+    void unsubscribe(SubId id) {
+        {
+            std::scoped_lock lk(mu_);
+            auto next = std::make_shared<SubList>();
+            for(const auto& s : *subs_) if(s.id != id) next->push_back(s);
+            std::atomic_store_explicit(&subs_, std::shared_ptr<const SubList>(std::move(next)),
+                                       std::memory_order_seq_cst);
+        }
+        if(std::this_thread::get_id() == th_.get_id()) return;
+        const uint64_t g = dispatch_gen_.load(std::memory_order_seq_cst);
+        if(g & 1){
+            while(dispatch_gen_.load(std::memory_order_acquire) == g) std::this_thread::yield();
+        }
+    }
+
+    // waits while the ring is full; false once stopped (a publish caught
+    // waiting by stop() gives up and counts as dropped)
+    bool publish(T v) {
+        if(!enter()) return false;
+        Typed<T> e = stamp(std::move(v));
+        while(!ring_.try_push(std::move(e))){
+            if(!run_.load(std::memory_order_relaxed)){
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                leave();
+                return false;
+            }
+            full_.fetch_add(1, std::memory_order_relaxed);
+            bell_.ring();
+            std::this_thread::yield();
+        }
+        published_.fetch_add(1, std::memory_order_relaxed);
+        leave();
+        bell_.ring();
+        return true;
+    }
+
+    // never waits: false (value dropped) if the ring is full
+    bool try_publish(T v) {
+        if(!enter()) return false;
+        const bool ok = ring_.try_push(stamp(std::move(v)));
+        if(ok) published_.fetch_add(1, std::memory_order_relaxed);
+        else full_.fetch_add(1, std::memory_order_relaxed);
+        leave();
+        if(ok) bell_.ring();
+        return ok;
+    }
+
+    // drains what was published, then joins the dispatcher
+    void stop() {
+        if(!run_.exchange(false, std::memory_order_seq_cst)) return;
+        // in-flight publishes either land before the final drain or give up
+        while(publishing_.load(std::memory_order_seq_cst) != 0){
+            bell_.ring();
+            std::this_thread::yield();
+        }
+        bell_.ring();
+        if(th_.joinable()) th_.join();
+    }
+
+    Topic topic() const { return topic_; }
+    uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+    uint64_t dispatched() const { return dispatched_.load(std::memory_order_relaxed); }
+    uint64_t full() const { return full_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+};
+
+}
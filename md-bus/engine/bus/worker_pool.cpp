@@ -0,0 +1,108 @@
+#include "worker_pool.hpp"
+
+#include "../common/log.hpp"
+#include "../common/thread_util.hpp"
+
+namespace md {
+
+WorkerPool::WorkerPool(const PoolOptions& opts)
+    : opts_{opts} {
+    const size_t threads = opts_.threads ? opts_.threads : 1;
+    workers_.reserve(threads);
+    for(size_t i = 0; i < threads; ++i){
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    // start only once every run-queue exists, workers steal from each other
+    for(size_t i = 0; i < threads; ++i){
+        workers_[i]->th = std::thread([this, i]{ worker_loop(i); });
+    }
+    log_info("WorkerPool started (threads = {}, pinned = {}, budget = {}, wait = {})",
+             threads, (opts_.pin || !opts_.cpus.empty()) ? 1 : 0, budget(), to_string(opts_.wait));
+}
+
+WorkerPool::~WorkerPool() { stop(); }
+
+void WorkerPool::attach(Strand& s){
+    s.home_ = next_home_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+}
+
+void WorkerPool::push(size_t w, std::shared_ptr<Strand> s){
+    {
+        std::scoped_lock lk(workers_[w]->mu);
+        workers_[w]->q.push_back(std::move(s));
+    }
+    pending_.fetch_add(1, std::memory_order_release);
+    bell_.ring();
+}
+
+// own queue first (front), then steal from the back of the others
+std::shared_ptr<Strand> WorkerPool::take(size_t w){
+    std::shared_ptr<Strand> s;
+    {
+        auto& me = *workers_[w];
+        std::scoped_lock lk(me.mu);
+        if(!me.q.empty()){
+            s = std::move(me.q.front());
+            me.q.pop_front();
+        }
+    }
+    for(size_t k = 1; !s && k < workers_.size(); ++k){
+        auto& victim = *workers_[(w + k) % workers_.size()];
+        std::scoped_lock lk(victim.mu);
+        if(!victim.q.empty()){
+            s = std::move(victim.q.back());
+            victim.q.pop_back();
+            steals_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if(s) pending_.fetch_sub(1, std::memory_order_relaxed);
+    return s;
+}
+
+void WorkerPool::worker_loop(size_t w){
+    ThreadConfig tc{.name = fmt::format("{}-{}", opts_.name, w),
+                    .fifo_priority = opts_.fifo_priority};
+    if(!opts_.cpus.empty()) tc.cpu = opts_.cpus[w % opts_.cpus.size()];
+    else if(opts_.pin) tc.cpu = static_cast<int>(w % hw_threads());
+    apply_thread_config(tc);
+    current_ = this;
+
+    for(;;){
+        auto s = take(w);
+        if(!s){
+            bell_.wait([this]{
+                return pending_.load(std::memory_order_acquire) > 0 ||
+                       !run_.load(std::memory_order_acquire);
+            }, opts_.wait);
+            if(!run_.load(std::memory_order_acquire) &&
+               pending_.load(std::memory_order_acquire) == 0) break;
+            continue;
+        }
+
+        runs_.fetch_add(1, std::memory_order_relaxed);
+        switch(s->execute(budget())){
+            case StrandState::More:
+                push(w, std::move(s));
+                break;
+            case StrandState::Idle:
+                // pairs with the exchange in schedule(): either the producer
+                // sees the flag down and schedules, or we see its work here
+                s->scheduled_.store(false, std::memory_order_seq_cst);
+                if(s->has_work()) schedule(s);
+                break;
+            case StrandState::Retired:
+                break;
+        }
+    }
+}
+
+void WorkerPool::stop(){
+    if(!run_.exchange(false)) return;
+    bell_.ring();
+    for(auto& w : workers_){
+        if(w->th.joinable()) w->th.join();
+    }
+    log_info("WorkerPool stopped (runs = {}, steals = {})", runs(), steals());
+}
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../common/wait.hpp"
+
+namespace md {
+
+enum class StrandState : uint8_t {
+    More,     // budget used up, still has work: requeue
+    Idle,     // drained: release the strand until somebody schedules it
+    Retired,  // finished for good: never touch it again
+};
+
+/**
+ * Strand
+ * ------
+ * A serial execution context on the WorkerPool. The pool guarantees that a
+ * strand is in at most one run-queue and run by at most one worker at a
+ * time, so whatever it drains is processed in order, even though
+ * successive runs may land on different workers.
+ */
+class Strand {
+public:
+    virtual ~Strand() = default;
+
+    // process up to budget items
+    virtual StrandState execute(size_t budget) = 0;
+
+    // anything left that needs a run (checked after going Idle)
+    virtual bool has_work() const = 0;
+
+private:
+    friend class WorkerPool;
+    std::atomic<bool> scheduled_{false};
+    size_t home_{0}; // worker whose run-queue gets it first
+};
+
+struct PoolOptions {
+    size_t threads = 1;
+    size_t budget = 64;                 // items per strand run before requeue
+    WaitStrategy wait = WaitStrategy::SpinPark;
+    bool pin = false;                   // worker i -> cpu i % hw_threads()
+    std::vector<int> cpus;              // worker i -> cpus[i % size], wins over pin
+    int fifo_priority = 0;              // > 0: SCHED_FIFO
+    std::string name = "md-pool";       // threads are named <name>-<i>
+};
+
+/**
+ * WorkerPool
+ * ----------
+ * M:N executor: a fixed set of (optionally pinned) worker threads runs any
+ * number of strands.
+ *  - schedule() is cheap when the strand is already queued or running
+ *  - each worker owns a run-queue and pops from its front; an idle worker
+ *    steals from the back of the others before parking
+ *  - run-queues hold shared_ptr so a strand outlives any run in flight
+ */
+class WorkerPool {
+private:
+    struct Worker {
+        std::mutex mu;
+        std::deque<std::shared_ptr<Strand>> q;
+        std::thread th;
+    };
+
+    const PoolOptions opts_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<size_t> next_home_{0};
+    std::atomic<size_t> pending_{0};   // strands sitting in run-queues
+    std::atomic<bool> run_{true};
+    Doorbell bell_;
+
+    std::atomic<uint64_t> runs_{0};
+    std::atomic<uint64_t> steals_{0};
+
+    // pool whose worker_loop runs on this thread, if any
+    static inline thread_local const WorkerPool* current_ = nullptr;
+
+    void push(size_t w, std::shared_ptr<Strand> s);
+    std::shared_ptr<Strand> take(size_t w);
+    void worker_loop(size_t w);
+
+public:
+    explicit WorkerPool(const PoolOptions& opts);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // spread new strands round-robin over the workers
+    void attach(Strand& s);
+
+    // make sure s gets (another) run; no-op if it is already queued/running.
+    // Templated so the common "already scheduled" case costs one exchange
+    // and no shared_ptr conversion.
+    template <typename S>
+    void schedule(const std::shared_ptr<S>& s) {
+        if (s->scheduled_.exchange(true, std::memory_order_seq_cst)) return;
+        push(s->home_, s);
+    }
+
+    void stop();
+
+    // true on one of this pool's workers, i.e. inside a strand run. Code
+    // that would wait for a strand to run must not do so from here.
+    bool on_worker() const { return current_ == this; }
+
+    size_t size() const { return workers_.size(); }
+    size_t budget() const { return opts_.budget ? opts_.budget : 1; }
+    WaitStrategy wait_strategy() const { return opts_.wait; }
+    uint64_t runs() const { return runs_.load(std::memory_order_relaxed); }
+    uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+};
+
+}
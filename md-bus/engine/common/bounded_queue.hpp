@@ -39,6 +39,20 @@ public:
         }
         return false;
     }
+    // non blocking : if full, evict the oldest element to make room
+    // returns true if something was evicted
+    bool push_evict_oldest(T item){
+        std::unique_lock<std::mutex> lock(mutex_);
+        if(capacity_ == 0) return true;
+        bool evicted = false;
+        if(queue_.size() >= capacity_){
+            queue_.pop();
+            evicted = true;
+        }
+        queue_.push(std::move(item));
+        not_empty_.notify_one();
+        return evicted;
+    }
     //blocking 
     bool pop(T &out){
         std::unique_lock<std::mutex> lock(mutex_);
@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "spsc_ring.hpp"
+
+namespace md {
+
+// Disruptor-style broadcast ring.
+//  - one producer writes each item exactly once into a sequenced slot
+//  - every reader owns a Cursor (next sequence it will read) and reads the
+//    slot in place, so fan-out costs one cursor store per reader instead of
+//    one copy per reader
+//  - the producer is gated by the slowest cursor: it never overwrites a slot
+//    some reader has not moved past yet
+// The producer caches the gating sequence and only rescans cursors (under
+// readers_mu_) when the ring looks full.
+template <typename T>
+class BroadcastRing {
+public:
+    struct alignas(kCacheLine) Cursor {
+        std::atomic<uint64_t> next{0};
+    };
+
+private:
+    const uint64_t capacity_;
+    const uint64_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    alignas(kCacheLine) std::atomic<uint64_t> published_{0}; // next seq to write
+    uint64_t cached_min_{0};                                 // producer only
+
+    std::mutex readers_mu_;
+    std::vector<std::shared_ptr<Cursor>> readers_;
+
+    uint64_t min_cursor(uint64_t head) {
+        std::scoped_lock lk(readers_mu_);
+        uint64_t m = head;
+        for (auto& r : readers_) {
+            m = std::min(m, r->next.load(std::memory_order_acquire));
+        }
+        return m;
+    }
+
+public:
+    explicit BroadcastRing(std::size_t capacity)
+        : capacity_{round_up_pow2(capacity ? capacity : 1)},
+          mask_{capacity_ - 1},
+          slots_{new T[capacity_]} {}
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    // a new reader starts at the current head: it only sees what is
+    // published after it joined
+    std::shared_ptr<Cursor> add_reader() {
+        auto c = std::make_shared<Cursor>();
+        std::scoped_lock lk(readers_mu_);
+        c->next.store(published_.load(std::memory_order_acquire), std::memory_order_relaxed);
+        readers_.push_back(c);
+        return c;
+    }
+
+    void remove_reader(const std::shared_ptr<Cursor>& c) {
+        std::scoped_lock lk(readers_mu_);
+        readers_.erase(std::remove(readers_.begin(), readers_.end(), c), readers_.end());
+    }
+
+    // producer only; waits while the slowest reader is a full lap behind.
+    // on_full(gating_seq) runs before every yield: it should wake readers
+    // that may be parked, and returns false to give up (item not written).
+    template <typename U, typename OnFull>
+    bool publish(U&& item, OnFull&& on_full) {
+        const uint64_t seq = published_.load(std::memory_order_relaxed);
+        while (seq - cached_min_ >= capacity_) {
+            cached_min_ = min_cursor(seq);
+            if (seq - cached_min_ < capacity_) break;
+            if (!on_full(cached_min_)) return false;
+            std::this_thread::yield();
+        }
+        slots_[seq & mask_] = std::forward<U>(item);
+        published_.store(seq + 1, std::memory_order_release);
+        return true;
+    }
+
+    // readers never park: just wait
+    template <typename U>
+    void publish(U&& item) {
+        publish(std::forward<U>(item), [](uint64_t) { return true; });
+    }
+
+    uint64_t published() const { return published_.load(std::memory_order_acquire); }
+
+    bool available(const Cursor& c) const {
+        return c.next.load(std::memory_order_relaxed) < published();
+    }
+
+    // reader: valid until the reader advances its cursor past seq
+    const T& at(uint64_t seq) const { return slots_[seq & mask_]; }
+
+    std::size_t capacity() const { return capacity_; }
+};
+
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include "event.hpp"
+
+namespace md {
+
+// Latest-value queue keyed by (topic, symbol).
+//  - at most one pending event per key: a later tick for a symbol that is
+//    still queued overwrites the queued one in place, keeping its position
+//  - events without a symbol (LOG, HEARTBEAT) are queued as usual
+// So after a burst the consumer catches up in O(symbols) pops and always
+// sees the freshest state. capacity only bounds the total queue length;
+// past it, new keys / unkeyed events are dropped.
+//
+// Mode::WhenFull queues everything in order while there is room and only
+// conflates once full: the incoming event replaces the newest queued event
+// with its key, or is dropped if none is queued.
+class ConflatingQueue {
+public:
+    enum class PushResult : uint8_t { Queued, Conflated, Dropped };
+    enum class Mode : uint8_t { Always, WhenFull };
+
+private:
+    const size_t capacity_;
+    const Mode mode_;
+    mutable std::mutex mu_;
+    std::deque<Event> q_;
+    uint64_t head_{0}; // absolute index of q_.front()
+    // absolute index of the newest queued event per key
+    std::array<std::unordered_map<SymbolId, uint64_t>, kTopicCount> pending_;
+
+public:
+    explicit ConflatingQueue(size_t capacity, Mode mode = Mode::Always)
+        : capacity_{capacity ? capacity : 1}, mode_{mode} {}
+
+    PushResult push(const Event& ev) {
+        std::scoped_lock lk(mu_);
+        const auto topic = static_cast<size_t>(ev.h.topic);
+        const SymbolId sym = symbol_of(ev.p);
+        const bool full = q_.size() >= capacity_;
+        if (!sym.empty() && topic < kTopicCount) {
+            auto& idx = pending_[topic];
+            auto it = idx.find(sym);
+            if (it != idx.end() && (full || mode_ == Mode::Always)) {
+                q_[it->second - head_] = ev;
+                return PushResult::Conflated;
+            }
+            if (full) return PushResult::Dropped;
+            idx[sym] = head_ + q_.size();
+        } else if (full) {
+            return PushResult::Dropped;
+        }
+        q_.push_back(ev);
+        return PushResult::Queued;
+    }
+
+    bool try_pop(Event& out) {
+        std::scoped_lock lk(mu_);
+        if (q_.empty()) return false;
+        out = std::move(q_.front());
+        q_.pop_front();
+        const auto topic = static_cast<size_t>(out.h.topic);
+        const SymbolId sym = symbol_of(out.p);
+        if (!sym.empty() && topic < kTopicCount) {
+            auto& idx = pending_[topic];
+            auto it = idx.find(sym);
+            if (it != idx.end() && it->second == head_) idx.erase(it);
+        }
+        ++head_;
+        return true;
+    }
+
+    size_t size() const {
+        std::scoped_lock lk(mu_);
+        return q_.size();
+    }
+
+    bool empty() const { return size() == 0; }
+};
+
+}
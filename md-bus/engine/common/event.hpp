@@ -1,9 +1,14 @@
 #pragma once
 #include <cstdint>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <variant>
 #include <chrono>
 
+#include "price.hpp"
+#include "symbol.hpp"
+
 namespace md {
     
 enum class Topic : uint8_t {
@@ -19,12 +24,15 @@ enum class Topic : uint8_t {
     RISK_ALERT = 9
 };
 
+// keep in sync with the last enumerator; sizes every per-topic table
+inline constexpr size_t kTopicCount = static_cast<size_t>(Topic::RISK_ALERT) + 1;
+
 struct Bar {
-    std::string symbol;
-    double open{0.0};
-    double close{0.0};
-    double high{0.0};
-    double low{0.0};
+    SymbolId symbol;
+    Price open;
+    Price close;
+    Price high;
+    Price low;
     int volume{0};
     uint64_t start_ts_ns{0};
     uint64_t end_ts_ns{0};
@@ -38,8 +46,8 @@ struct Header {
 };
 
 struct Tick {
-    std::string symbol;
-    double pq{0.0};
+    SymbolId symbol;
+    Price pq;
     uint32_t qty{0};
 };
 
@@ -52,41 +60,41 @@ enum class OrderType : uint8_t { Market = 0, Limit = 1 };
 
 struct Order {
     uint64_t order_id{0};
-    std::string symbol;
+    SymbolId symbol;
     Side side{Side::Buy};
     OrderType type{OrderType::Market};
 
     int qty{0};
-    double price{0.0};          // for limit (or fill reference)
+    Price price;                // for limit (or fill reference)
 };
 
 struct Trade {
     uint64_t order_id{0};
     uint64_t trade_id{0};
-    std::string symbol;
+    SymbolId symbol;
     Side side{Side::Buy};
 
     int qty{0};
-    double price{0.0};
+    Price price;
 };
 
 struct Reject {
     uint64_t order_id{0};
-    std::string symbol;
+    SymbolId symbol;
     int code{0};
     std::string reason;
 };
 
 struct BookUpdate {
-    std::string symbol;
-    double best_bid{0.0};
-    double best_ask{0.0};
+    SymbolId symbol;
+    Price best_bid;
+    Price best_ask;
     int bid_qty{0};
     int ask_qty{0};
 };
 
 struct RiskAlert {
-    std::string symbol;
+    SymbolId symbol;
     int code{0};
     std::string reason;
 };
@@ -110,6 +118,56 @@ struct Event {
     Payload p;
 };
 
-
-
-}
\ No newline at end of file
+// compile-time topic -> payload type. Typed publish/subscribe (EventBus,
+// Channel) go through this, so a topic can't carry the wrong payload.
+template <Topic T> struct TopicTraits;
+template <> struct TopicTraits<Topic::LOG>         { using type = std::string; };
+template <> struct TopicTraits<Topic::MD_TICK>     { using type = Tick; };
+template <> struct TopicTraits<Topic::HEARTBEAT>   { using type = Heartbeat; };
+template <> struct TopicTraits<Topic::BAR_1S>      { using type = Bar; };
+template <> struct TopicTraits<Topic::BAR_1M>      { using type = Bar; };
+template <> struct TopicTraits<Topic::ORDER>       { using type = Order; };
+template <> struct TopicTraits<Topic::TRADE>       { using type = Trade; };
+template <> struct TopicTraits<Topic::REJECT>      { using type = Reject; };
+template <> struct TopicTraits<Topic::BOOK_UPDATE> { using type = BookUpdate; };
+template <> struct TopicTraits<Topic::RISK_ALERT>  { using type = RiskAlert; };
+
+template <Topic T>
+using payload_t = typename TopicTraits<T>::type;
+
+// a new Topic without a TopicTraits entry fails to compile here
+template <size_t... I>
+constexpr bool all_topics_typed(std::index_sequence<I...>) {
+    return (sizeof(payload_t<static_cast<Topic>(I)>) + ...) > 0;
+}
+static_assert(all_topics_typed(std::make_index_sequence<kTopicCount>{}),
+              "every Topic needs a TopicTraits entry");
+
+// topic a payload type is published on when nothing else is said
+// (Bar: BAR_1S; a BAR_1M channel names its topic explicitly)
+template <typename P> struct DefaultTopic;
+template <> struct DefaultTopic<std::string> { static constexpr Topic value = Topic::LOG; };
+template <> struct DefaultTopic<Tick>        { static constexpr Topic value = Topic::MD_TICK; };
+template <> struct DefaultTopic<Heartbeat>   { static constexpr Topic value = Topic::HEARTBEAT; };
+template <> struct DefaultTopic<Bar>         { static constexpr Topic value = Topic::BAR_1S; };
+template <> struct DefaultTopic<Order>       { static constexpr Topic value = Topic::ORDER; };
+template <> struct DefaultTopic<Trade>       { static constexpr Topic value = Topic::TRADE; };
+template <> struct DefaultTopic<Reject>      { static constexpr Topic value = Topic::REJECT; };
+template <> struct DefaultTopic<BookUpdate>  { static constexpr Topic value = Topic::BOOK_UPDATE; };
+template <> struct DefaultTopic<RiskAlert>   { static constexpr Topic value = Topic::RISK_ALERT; };
+
+// symbol carried by the payload; the empty symbol for LOG/HEARTBEAT/empty
+inline SymbolId symbol_of(const Payload& p) {
+    return std::visit([](const auto& v) -> SymbolId {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, std::monostate> ||
+                      std::is_same_v<T, std::string> ||
+                      std::is_same_v<T, Heartbeat>) {
+            return {};
+        } else {
+            return v.symbol;
+        }
+    }, p);
+}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "event.hpp"
+
+namespace md {
+
+// price / quantity carried by the payload, for filters; false when the
+// payload has none (LOG, HEARTBEAT, Reject, RiskAlert, BookUpdate)
+inline bool price_qty_of(const Payload& p, Price& px, uint64_t& qty) {
+    return std::visit([&](const auto& v) -> bool {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, Tick>) {
+            px = v.pq; qty = v.qty; return true;
+        } else if constexpr (std::is_same_v<T, Bar>) {
+            px = v.close; qty = v.volume > 0 ? (uint64_t)v.volume : 0; return true;
+        } else if constexpr (std::is_same_v<T, Order> || std::is_same_v<T, Trade>) {
+            px = v.price; qty = v.qty > 0 ? (uint64_t)v.qty : 0; return true;
+        } else {
+            return false;
+        }
+    }, p);
+}
+
+// per-subscription filter, evaluated by the reactor before an event is
+// queued, so rejected events cost neither a copy nor a wake-up. All set
+// parts must match; a default EventFilter lets everything through.
+//
+//   SubOptions{.filter = {.symbols = {"NIFTY", "BANKNIFTY"}, .min_qty = 100}}
+//
+// symbols are not checked per subscriber: the bus indexes the subscription
+// under each of them, so an event only reaches subscribers of its symbol.
+struct EventFilter {
+    std::vector<SymbolId> symbols;      // any of these (empty: any symbol)
+
+    // price/qty window (see price_qty_of); with either set, events without
+    // a price are rejected
+    Price min_price = Price::min();
+    Price max_price = Price::max();
+    uint64_t min_qty = 0;
+
+    // anything else; runs on the reactor thread, keep it short and don't block
+    std::function<bool(const Event&)> where;
+
+    bool by_symbol() const { return !symbols.empty(); }
+    bool by_price_qty() const {
+        return min_price != Price::min() || max_price != Price::max() || min_qty != 0;
+    }
+    // anything left to check once the symbol index picked the subscriber
+    bool by_fields() const { return by_price_qty() || static_cast<bool>(where); }
+    bool empty() const { return !by_symbol() && !by_fields(); }
+
+    bool matches_fields(const Event& e) const {
+        if(by_price_qty()){
+            Price px;
+            uint64_t qty = 0;
+            if(!price_qty_of(e.p, px, qty)) return false;
+            if(px < min_price || px > max_price || qty < min_qty) return false;
+        }
+        return !where || where(e);
+    }
+
+    bool matches(const Event& e) const {
+        if(by_symbol()){
+            const SymbolId sym = symbol_of(e.p);
+            if(sym.empty()) return false;
+            bool hit = false;
+            for(SymbolId s : symbols) if(s == sym){ hit = true; break; }
+            if(!hit) return false;
+        }
+        return matches_fields(e);
+    }
+};
+
+}
@@ -2,6 +2,7 @@
 #include <string>
 #include <string_view>
 #include <variant>
+#include <vector>
 
 #include "event.hpp"
 
@@ -42,7 +43,7 @@ inline bool topic_from_string(std::string_view s, Topic& out){
 // --- Payload serialization ---
 // Format:
 //   monostate: "-"
-//   Tick:      "TICK|<symbol>|<pq>|<qty>"
+//   Tick:      "TICK|<symbol>|<pq>|<qty>"   (pq exact, see format_price)
 //   Log:       "LOG|<text>"
 // (We assume log text doesn’t contain newlines or '|'; fine for now.)
 
@@ -56,9 +57,9 @@ inline std::string serialize_payload(const Payload& p){
         std::string s;
         s.reserve(64);
         s.append("TICK|");
-        s.append(t.symbol);
+        s.append(t.symbol.name()); // ids are per process, files carry names
         s.push_back('|');
-        s.append(std::to_string(t.pq));
+        s.append(format_price(t.pq));
         s.push_back('|');
         s.append(std::to_string(t.qty));
         return s;
@@ -79,7 +80,7 @@ inline std::string serialize_payload(const Payload& p){
 // Line format:
 //   seq,ts_ns,topic,payload
 // Example:
-//   0,1234567890,MD_TICK,TICK|NIFTY|22500.0|100
+//   0,1234567890,MD_TICK,TICK|NIFTY|22500.25|100
 
 inline std::string serialize_event(const Event& e){
     std::string s;
@@ -128,9 +129,9 @@ inline Payload parse_payload(std::string_view s) {
             return std::monostate{};
         }
         Tick t;
-        t.symbol = std::string(parts[0]);
+        t.symbol = SymbolId(parts[0]);
+        if(!parse_price(parts[1], t.pq)) return std::monostate{};
         try{
-            t.pq = std::stod(std::string(parts[1]));
             t.qty = static_cast<uint32_t>(std::stoul(std::string(parts[2])));
         }catch(...) {
             return std::monostate{};
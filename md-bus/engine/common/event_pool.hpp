@@ -0,0 +1,115 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "event.hpp"
+
+namespace md {
+
+class EventPool;
+
+// one event shared by every subscriber it is routed to; read-only once
+// handed out
+struct EventEnvelope {
+    Event ev;
+    std::atomic<uint32_t> refs{0};
+    EventPool* pool{nullptr};
+    EventEnvelope* next_free{nullptr};
+};
+
+// intrusive ref to a pooled envelope; the last one to go hands the
+// envelope back to its pool (from whatever thread that happens on)
+class EventRef {
+private:
+    EventEnvelope* p_{nullptr};
+
+    inline void release();
+
+public:
+    EventRef() = default;
+    explicit EventRef(EventEnvelope* p) : p_{p} {
+        if (p_) p_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    EventRef(const EventRef& o) : EventRef(o.p_) {}
+    EventRef(EventRef&& o) noexcept : p_{std::exchange(o.p_, nullptr)} {}
+    EventRef& operator=(EventRef o) noexcept {
+        std::swap(p_, o.p_);
+        return *this;
+    }
+    ~EventRef() { release(); }
+
+    const Event& operator*() const { return p_->ev; }
+    const Event* operator->() const { return &p_->ev; }
+    explicit operator bool() const { return p_ != nullptr; }
+};
+
+/**
+ * EventPool
+ * ---------
+ * Free list of envelopes for the reactor.
+ *  - make() is reactor only: it pops from a private list and, when that
+ *    runs dry, grabs everything subscribers returned in one exchange
+ *  - returns are a lock-free push onto a shared stack from any thread;
+ *    since the only pop is "take the whole stack", there is no ABA
+ *  - grows in chunks and never shrinks; envelopes live as long as the pool
+ */
+class EventPool {
+private:
+    static constexpr size_t kChunk = 256;
+
+    std::vector<std::unique_ptr<EventEnvelope[]>> chunks_; // reactor only
+    EventEnvelope* local_{nullptr};                        // reactor only
+    std::atomic<EventEnvelope*> returned_{nullptr};
+    std::atomic<size_t> allocated_{0};
+
+    void grow() {
+        auto chunk = std::make_unique<EventEnvelope[]>(kChunk);
+        for (size_t i = 0; i < kChunk; ++i) {
+            chunk[i].pool = this;
+            chunk[i].next_free = local_;
+            local_ = &chunk[i];
+        }
+        chunks_.push_back(std::move(chunk));
+        allocated_.fetch_add(kChunk, std::memory_order_relaxed);
+    }
+
+public:
+    EventPool() = default;
+    EventPool(const EventPool&) = delete;
+    EventPool& operator=(const EventPool&) = delete;
+
+    // reactor only: move ev into a fresh envelope
+    EventRef make(Event&& ev) {
+        if (!local_) local_ = returned_.exchange(nullptr, std::memory_order_acquire);
+        if (!local_) grow();
+        EventEnvelope* e = local_;
+        local_ = e->next_free;
+        e->next_free = nullptr;
+        e->ev = std::move(ev);
+        return EventRef(e);
+    }
+
+    // any thread, via EventRef
+    void recycle(EventEnvelope* e) {
+        EventEnvelope* head = returned_.load(std::memory_order_relaxed);
+        do {
+            e->next_free = head;
+        } while (!returned_.compare_exchange_weak(head, e, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+    }
+
+    size_t allocated() const { return allocated_.load(std::memory_order_relaxed); }
+};
+
+inline void EventRef::release() {
+    if (p_ && p_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        p_->pool->recycle(p_);
+    }
+    p_ = nullptr;
+}
+
+}
@@ -6,7 +6,8 @@
 #include <thread>
 #include <utility>
 #include <mutex>
-#include <functional> 
+#include <functional>
+#include <atomic>
 
 namespace md {
 enum class LogLevel {
@@ -1,7 +1,14 @@
 #pragma once
 #include <cstdint>
 #include <array>
+#include <atomic>
+#include <memory>
 #include <algorithm>
+#include <string>
+#include <vector>
+
+#include "event.hpp"
+#include "wait.hpp"
 
 namespace md {
 
@@ -59,6 +66,197 @@ struct Log2Histogram {
         if(n == 0)return 0;
         return (uint64_t)(sum / (long double)n);
     }
+
+    void merge(const Log2Histogram& o) {
+        if(o.n == 0) return;
+        for(size_t i = 0; i < MAX_B; ++i) b[i] += o.b[i];
+        n += o.n;
+        min_v = std::min(min_v, o.min_v);
+        max_v = std::max(max_v, o.max_v);
+        sum += o.sum;
+    }
+};
+
+// HDR-style log-linear bucketing: every power of two [2^e, 2^(e+1)) is cut
+// into `half` equal sub-buckets, with half >= 10^Digits, so a value is
+// known to within 1/half of itself (Digits = 2: < 0.8%) while the table
+// stays small. Values below 2*half are exact; values >= 2^MaxExp land in
+// the last bucket.
+template <int Digits = 2, int MaxExp = 36>
+struct HdrLayout {
+    static constexpr uint64_t pow10(int d) { return d <= 0 ? 1 : 10 * pow10(d - 1); }
+    static constexpr int log2_ceil(uint64_t v) { int b = 0; while ((1ULL << b) < v) ++b; return b; }
+
+    static constexpr int sub_bits = log2_ceil(pow10(Digits)) + 1;   // 2^sub_bits exact values
+    static constexpr uint64_t half = 1ULL << (sub_bits - 1);         // sub-buckets per power of two
+    static constexpr size_t size = (1ULL << sub_bits) + (MaxExp - sub_bits) * half;
+    static_assert(Digits >= 1 && Digits <= 5, "1..5 significant digits");
+    static_assert(MaxExp > sub_bits && MaxExp < 64, "MaxExp out of range");
+
+    static size_t index_of(uint64_t v) {
+        if (v < (1ULL << sub_bits)) return static_cast<size_t>(v);
+        const int e = 63 - __builtin_clzll(v);
+        if (e >= MaxExp) return size - 1;
+        const int shift = e - (sub_bits - 1);
+        const uint64_t top = v >> shift; // in [half, 2*half)
+        return static_cast<size_t>((1ULL << sub_bits) + (e - sub_bits) * half + (top - half));
+    }
+
+    // largest value that maps to idx
+    static uint64_t highest_equivalent(size_t idx) {
+        if (idx < (1ULL << sub_bits)) return idx;
+        const uint64_t k = idx - (1ULL << sub_bits);
+        const int e = sub_bits + static_cast<int>(k / half);
+        const int shift = e - (sub_bits - 1);
+        const uint64_t top = half + k % half;
+        return ((top + 1) << shift) - 1;
+    }
+};
+
+// mergeable HDR-style histogram (see HdrLayout); percentiles are reported as
+// the top of the sub-bucket holding that rank, clamped to [min, max]
+template <int Digits = 2, int MaxExp = 36>
+struct HdrHistogram {
+    using Layout = HdrLayout<Digits, MaxExp>;
+
+    std::vector<uint64_t> c = std::vector<uint64_t>(Layout::size, 0);
+    uint64_t n = 0;
+    uint64_t min_v = (uint64_t)-1;
+    uint64_t max_v = 0;
+    long double sum = 0.0L;
+
+    void record(uint64_t x) {
+        ++c[Layout::index_of(x)];
+        ++n;
+        min_v = std::min(min_v, x);
+        max_v = std::max(max_v, x);
+        sum += (long double)x;
+    }
+
+    void merge(const HdrHistogram& o) {
+        if (o.n == 0) return;
+        for (size_t i = 0; i < Layout::size; ++i) c[i] += o.c[i];
+        n += o.n;
+        min_v = std::min(min_v, o.min_v);
+        max_v = std::max(max_v, o.max_v);
+        sum += o.sum;
+    }
+
+    //p [0, 1] percentile: the value at rank ceil(p * n)
+    uint64_t percentile(double p) const {
+        if (n == 0) return 0;
+        if (p <= 0.0) return min_v;
+        if (p >= 1.0) return max_v;
+        long double r = (long double)n * (long double)p;
+        uint64_t rank = (uint64_t)r;
+        if ((long double)rank < r) ++rank;
+        if (rank == 0) rank = 1;
+        uint64_t cum = 0;
+        for (size_t i = 0; i < Layout::size; ++i) {
+            cum += c[i];
+            if (cum >= rank) {
+                return std::clamp(Layout::highest_equivalent(i), min_v, max_v);
+            }
+        }
+        return max_v;
+    }
+
+    uint64_t avg() const {
+        if (n == 0) return 0;
+        return (uint64_t)(sum / (long double)n);
+    }
+};
+
+using LatencyHistogram = HdrHistogram<2, 36>; // ~1% resolution, up to ~68s in ns
+
+// HdrHistogram with one writer and any number of readers. The writer
+// updates with relaxed load + store (no RMW, no lock), readers merge a copy
+// out with relaxed loads; a copy taken mid-record may be one sample off.
+template <int Digits = 2, int MaxExp = 36>
+struct SingleWriterHistogram {
+    using Layout = HdrLayout<Digits, MaxExp>;
+
+    // make_unique<T[]> value-initialises: all zero
+    std::unique_ptr<std::atomic<uint64_t>[]> c = std::make_unique<std::atomic<uint64_t>[]>(Layout::size);
+    std::atomic<uint64_t> n {0};
+    std::atomic<uint64_t> min_v {(uint64_t)-1};
+    std::atomic<uint64_t> max_v {0};
+    std::atomic<uint64_t> sum {0};
+
+    static void bump(std::atomic<uint64_t>& a, uint64_t by = 1) {
+        a.store(a.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    // writer only
+    void record(uint64_t x) {
+        bump(c[Layout::index_of(x)]);
+        bump(n);
+        bump(sum, x);
+        if (x < min_v.load(std::memory_order_relaxed)) min_v.store(x, std::memory_order_relaxed);
+        if (x > max_v.load(std::memory_order_relaxed)) max_v.store(x, std::memory_order_relaxed);
+    }
+
+    // any thread
+    void merge_into(HdrHistogram<Digits, MaxExp>& out) const {
+        if (n.load(std::memory_order_relaxed) == 0) return;
+        for (size_t i = 0; i < Layout::size; ++i) out.c[i] += c[i].load(std::memory_order_relaxed);
+        out.n += n.load(std::memory_order_relaxed);
+        out.min_v = std::min(out.min_v, min_v.load(std::memory_order_relaxed));
+        out.max_v = std::max(out.max_v, max_v.load(std::memory_order_relaxed));
+        out.sum += (long double)sum.load(std::memory_order_relaxed);
+    }
+};
+
+// condensed view of one histogram, what snapshots carry around
+struct LatencySummary {
+    uint64_t count = 0;
+    uint64_t min = 0;
+    uint64_t avg = 0;
+    uint64_t p50 = 0;
+    uint64_t p95 = 0;
+    uint64_t p99 = 0;
+    uint64_t max = 0;
+};
+
+template <typename Hist>
+LatencySummary summarize(const Hist& h) {
+    LatencySummary s;
+    s.count = h.n;
+    s.min = h.n ? h.min_v : 0;
+    s.avg = h.avg();
+    s.p50 = h.percentile(0.50);
+    s.p95 = h.percentile(0.95);
+    s.p99 = h.percentile(0.99);
+    s.max = h.max_v;
+    return s;
+}
+
+struct SubscriberDrops {
+    uint64_t id = 0;
+    std::string name;
+    uint64_t dropped = 0;
+};
+
+struct SubscriberStats {
+    uint64_t id = 0;
+    std::string name;
+    Topic topic = Topic::MD_TICK;
+    bool all = false;             // subscribe_all: topic is meaningless
+
+    uint64_t delivered = 0;       // callbacks run
+    uint64_t dropped = 0;
+    uint64_t depth = 0;           // queued right now (approximate)
+    uint64_t depth_hwm = 0;       // deepest the queue has been, seen by the reactor
+
+    LatencySummary latency;       // publish -> callback start
+    LatencySummary callback;      // time spent inside the callback
+};
+
+struct TopicStats {
+    Topic topic = Topic::MD_TICK;
+    uint64_t routed = 0;
+    LatencySummary latency;       // over every subscriber of the topic
+    LatencySummary callback;
 };
 
 struct PerfSnapshot{
@@ -66,6 +264,18 @@ struct PerfSnapshot{
     uint64_t duration_ns = 0;
     uint64_t eps = 0;
 
+    // events discarded by DropNewest/DropOldest/Conflate subscriptions
+    uint64_t dropped = 0;
+    std::vector<SubscriberDrops> drops; // live subscriptions with drops > 0
+
+    std::vector<uint64_t> shard_routed; // events routed per reactor shard
+
+    std::vector<SubscriberStats> subscribers; // live subscriptions, by id
+    std::vector<TopicStats> topics;           // topics with traffic
+
+    WaitStrategy reactor_wait = WaitStrategy::SpinPark;
+    WaitStrategy worker_wait = WaitStrategy::SpinPark; // default for subscriptions / pool
+
 
     uint64_t lat_min = 0;
     uint64_t lat_avg = 0;
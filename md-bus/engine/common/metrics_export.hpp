@@ -0,0 +1,215 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "metrics.hpp"
+
+namespace md {
+
+// metrics export: components fill a MetricSet from counters they already
+// keep (relaxed loads, no extra work on the hot path), a MetricsRegistry
+// holds the named sources, and the formatters below turn one collection
+// into Prometheus text or a JSON line. Scheduling/IO: io/metrics_exporter.hpp
+
+enum class MetricKind : uint8_t { Counter, Gauge };
+
+inline const char* to_string(MetricKind k){
+    return k == MetricKind::Counter ? "counter" : "gauge";
+}
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+struct MetricSample {
+    std::string name;
+    MetricKind kind = MetricKind::Gauge;
+    MetricLabels labels;
+    double value = 0.0;
+};
+
+class MetricSet {
+private:
+    std::vector<MetricSample> samples_;
+public:
+    void counter(std::string name, double v, MetricLabels labels = {}){
+        samples_.push_back(MetricSample{std::move(name), MetricKind::Counter, std::move(labels), v});
+    }
+    void gauge(std::string name, double v, MetricLabels labels = {}){
+        samples_.push_back(MetricSample{std::move(name), MetricKind::Gauge, std::move(labels), v});
+    }
+
+    // <name>{quantile=..} gauges plus <name>_count/_min/_max, the way a
+    // Prometheus summary is laid out
+    void latency(const std::string& name, const LatencySummary& s, const MetricLabels& labels = {}){
+        auto q = [&](const char* quantile, uint64_t v){
+            MetricLabels l = labels;
+            l.emplace_back("quantile", quantile);
+            gauge(name, (double)v, std::move(l));
+        };
+        q("0.5", s.p50);
+        q("0.95", s.p95);
+        q("0.99", s.p99);
+        counter(name + "_count", (double)s.count, labels);
+        gauge(name + "_min", (double)s.min, labels);
+        gauge(name + "_avg", (double)s.avg, labels);
+        gauge(name + "_max", (double)s.max, labels);
+    }
+
+    const std::vector<MetricSample>& samples() const { return samples_; }
+    std::vector<MetricSample>& samples() { return samples_; }
+    size_t size() const { return samples_.size(); }
+    void clear() { samples_.clear(); }
+};
+
+// named metric sources; add/remove/collect are control plane (one mutex),
+// sources run on the collecting thread and must only read
+class MetricsRegistry {
+public:
+    using Source = std::function<void(MetricSet&)>;
+    using SourceId = uint64_t;
+private:
+    struct Entry {
+        SourceId id;
+        std::string name;
+        Source fn;
+    };
+    mutable std::mutex mu_;
+    std::vector<Entry> sources_;
+    SourceId next_id_{1};
+public:
+    SourceId add(std::string name, Source fn){
+        std::scoped_lock lk(mu_);
+        const SourceId id = next_id_++;
+        sources_.push_back(Entry{id, std::move(name), std::move(fn)});
+        return id;
+    }
+
+    void remove(SourceId id){
+        std::scoped_lock lk(mu_);
+        sources_.erase(std::remove_if(sources_.begin(), sources_.end(),
+                                      [id](const Entry& e){ return e.id == id; }),
+                       sources_.end());
+    }
+
+    size_t size() const {
+        std::scoped_lock lk(mu_);
+        return sources_.size();
+    }
+
+    // every source in registration order; the source's name goes in as a
+    // `source` label unless it set one itself
+    MetricSet collect() const {
+        MetricSet out;
+        std::scoped_lock lk(mu_);
+        for(const auto& e : sources_){
+            const size_t from = out.size();
+            e.fn(out);
+            for(size_t i = from; i < out.size(); ++i){
+                auto& l = out.samples()[i].labels;
+                const bool has = std::any_of(l.begin(), l.end(),
+                                             [](const auto& kv){ return kv.first == "source"; });
+                if(!has) l.insert(l.begin(), {"source", e.name});
+            }
+        }
+        return out;
+    }
+};
+
+namespace detail {
+
+// integral values print without exponent/fraction, the rest shortest round-trip
+inline std::string metric_value(double v){
+    if(std::isnan(v)) return "NaN";
+    if(std::isinf(v)) return v > 0 ? "+Inf" : "-Inf";
+    if(v == std::floor(v) && std::fabs(v) < 9007199254740992.0){
+        return fmt::format("{}", (int64_t)v);
+    }
+    return fmt::format("{}", v);
+}
+
+// escaping shared by both formats: backslash, quote, newline
+inline void append_escaped(std::string& out, const std::string& s){
+    for(char c : s){
+        switch(c){
+            case '\\': out += "\\\\"; break;
+            case '"':  out += "\\\""; break;
+            case '\n': out += "\\n"; break;
+            default:   out += c;
+        }
+    }
+}
+
+}
+
+// Prometheus text exposition format (0.0.4): samples of one name are kept
+// together under a single # TYPE line
+inline std::string format_prometheus(const MetricSet& set){
+    std::vector<const MetricSample*> v;
+    v.reserve(set.size());
+    for(const auto& s : set.samples()) v.push_back(&s);
+    std::stable_sort(v.begin(), v.end(),
+                     [](const MetricSample* a, const MetricSample* b){ return a->name < b->name; });
+
+    std::string out;
+    const std::string* last = nullptr;
+    for(const MetricSample* s : v){
+        if(!last || *last != s->name){
+            out += fmt::format("# TYPE {} {}\n", s->name, to_string(s->kind));
+            last = &s->name;
+        }
+        out += s->name;
+        if(!s->labels.empty()){
+            out += '{';
+            for(size_t i = 0; i < s->labels.size(); ++i){
+                if(i) out += ',';
+                out += s->labels[i].first;
+                out += "=\"";
+                detail::append_escaped(out, s->labels[i].second);
+                out += '"';
+            }
+            out += '}';
+        }
+        out += ' ';
+        out += detail::metric_value(s->value);
+        out += '\n';
+    }
+    return out;
+}
+
+// one JSON object per collection, newline terminated:
+// {"ts_ns":..,"metrics":[{"name":..,"type":..,"labels":{..},"value":..},..]}
+// ts_ns is whatever the caller passes; MetricsExporter passes wall time
+inline std::string format_json_line(const MetricSet& set, uint64_t ts_ns){
+    std::string out = fmt::format("{{\"ts_ns\":{},\"metrics\":[", ts_ns);
+    bool first = true;
+    for(const auto& s : set.samples()){
+        if(!first) out += ',';
+        first = false;
+        out += "{\"name\":\"";
+        detail::append_escaped(out, s.name);
+        out += fmt::format("\",\"type\":\"{}\",\"labels\":{{", to_string(s.kind));
+        for(size_t i = 0; i < s.labels.size(); ++i){
+            if(i) out += ',';
+            out += '"';
+            detail::append_escaped(out, s.labels[i].first);
+            out += "\":\"";
+            detail::append_escaped(out, s.labels[i].second);
+            out += '"';
+        }
+        out += "},\"value\":";
+        // JSON has no NaN/Inf
+        out += std::isfinite(s.value) ? detail::metric_value(s.value) : std::string("null");
+        out += '}';
+    }
+    out += "]}\n";
+    return out;
+}
+
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "spsc_ring.hpp"
+
+namespace md {
+
+// Bounded multi-producer / single-consumer ring (Vyukov style).
+//  - every cell carries a sequence number that tells producers and the
+//    consumer whose turn it is, so producers only contend on one CAS of
+//    enqueue_pos_ and never on a lock
+//  - cell.seq == pos       : free, producer for pos may write
+//  - cell.seq == pos + 1   : written, consumer may read
+//  - cell.seq == pos + cap : read, free again for the next lap
+// Non blocking on both ends; try_push() returns false when full.
+template <typename T>
+class MpscRing {
+private:
+    struct Cell {
+        std::atomic<std::size_t> seq{0};
+        T value{};
+    };
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(kCacheLine) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(kCacheLine) std::atomic<std::size_t> dequeue_pos_{0};
+    char pad_[kCacheLine - sizeof(std::atomic<std::size_t>)];
+
+public:
+    explicit MpscRing(std::size_t capacity)
+        : capacity_{round_up_pow2(capacity < 2 ? 2 : capacity)},
+          mask_{capacity_ - 1},
+          cells_{new Cell[capacity_]} {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    // any thread; item is left untouched when the ring is full
+    template <typename U>
+    bool try_push(U&& item) {
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell* c = nullptr;
+        for (;;) {
+            c = &cells_[pos & mask_];
+            const std::size_t seq = c->seq.load(std::memory_order_acquire);
+            const auto dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (dif == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false; // full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        c->value = std::forward<U>(item);
+        c->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // any thread; claims n consecutive cells with a single CAS and moves
+    // first[0..n) into them. All or nothing: returns false (and moves
+    // nothing) if fewer than n cells are free or n > capacity.
+    bool try_push_n(T* first, std::size_t n) {
+        if (n == 0) return true;
+        if (n > capacity_) return false;
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            // the consumer frees cells in order, so if the last cell of the
+            // block is free for this lap, every cell before it is too
+            const std::size_t last = pos + n - 1;
+            const std::size_t seq = cells_[last & mask_].seq.load(std::memory_order_acquire);
+            const auto dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(last);
+            if (dif == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (dif < 0) {
+                return false; // not enough room
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            Cell& c = cells_[(pos + i) & mask_];
+            c.value = std::move(first[i]);
+            c.seq.store(pos + i + 1, std::memory_order_release);
+        }
+        return true;
+    }
+
+    // consumer only
+    bool try_pop(T& out) {
+        const std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell& c = cells_[pos & mask_];
+        if (c.seq.load(std::memory_order_acquire) != pos + 1) return false;
+        out = std::move(c.value);
+        c.seq.store(pos + capacity_, std::memory_order_release);
+        dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // consumer only: is the next cell ready to be read
+    bool empty() const {
+        const std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].seq.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    // approximate (counts claimed-but-not-yet-written cells)
+    std::size_t size() const {
+        const std::size_t d = dequeue_pos_.load(std::memory_order_relaxed);
+        const std::size_t e = enqueue_pos_.load(std::memory_order_relaxed);
+        return e >= d ? e - d : 0;
+    }
+
+    std::size_t capacity() const { return capacity_; }
+};
+
+}
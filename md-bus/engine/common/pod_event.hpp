@@ -0,0 +1,173 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "event.hpp"
+
+namespace md {
+
+// Event as two cache lines of plain bytes: header + payload union, symbol
+// as its SymbolId, LOG text and Reject/RiskAlert reasons inline (truncated
+// to fit). Trivially copyable, so rings and pools can move it with a
+// memcpy and it can sit in memory shared by threads without ever touching
+// the allocator. Everything up to a Tick fits in the first cache line.
+//
+// Symbol ids are per process; across processes use ShmEvent, which
+// carries names.
+struct alignas(64) PodEvent {
+    static constexpr size_t kLogCap = 96;      // LOG text
+    static constexpr size_t kReasonCap = 80;   // Reject / RiskAlert reason
+
+    // payload kinds, = Payload variant index
+    enum Kind : uint8_t {
+        None = 0, KTick, KText, KBar, KHeartbeat, KOrder, KTrade, KReject, KBook, KRisk,
+    };
+
+    // 32-byte header
+    uint64_t seq;
+    uint64_t ts_ns;
+    uint64_t t_pub_ns;
+    uint8_t topic;
+    uint8_t kind;
+    uint16_t text_len;
+    SymbolId symbol;
+
+    // 96-byte payload
+    // prices are Price::raw()
+    union {
+        struct { int64_t pq; uint32_t qty; } tick;
+        struct { int64_t open, close, high, low; int32_t volume; uint64_t start_ts_ns, end_ts_ns; } bar;
+        struct { uint64_t t_ms; } heartbeat;
+        struct { uint64_t order_id; int64_t price; int32_t qty; uint8_t side, type; } order;
+        struct { uint64_t order_id, trade_id; int64_t price; int32_t qty; uint8_t side; } trade;
+        struct { uint64_t order_id; int32_t code; char reason[kReasonCap]; } reject;
+        struct { int64_t best_bid, best_ask; int32_t bid_qty, ask_qty; } book;
+        struct { int32_t code; char reason[kReasonCap]; } risk;
+        char text[kLogCap];
+    } u;
+};
+
+static_assert(std::is_trivially_copyable_v<PodEvent>, "PodEvent must be memcpy-able");
+static_assert(std::is_standard_layout_v<PodEvent>, "PodEvent layout must be fixed");
+static_assert(sizeof(PodEvent) == 128, "PodEvent is two cache lines");
+static_assert(alignof(PodEvent) == 64, "PodEvent starts on a cache line");
+static_assert(offsetof(PodEvent, u) == 32, "header is 32 bytes");
+static_assert(offsetof(PodEvent, u) + sizeof(PodEvent{}.u.tick) <= 64, "a tick fits in one cache line");
+static_assert(PodEvent::KRisk + 1 == std::variant_size_v<Payload>, "PodEvent::Kind out of sync with Payload");
+
+namespace detail {
+
+inline bool pod_put(char* dst, size_t cap, const std::string& s, uint16_t& len_out) {
+    const size_t n = s.size() < cap ? s.size() : cap;
+    std::memcpy(dst, s.data(), n);
+    len_out = static_cast<uint16_t>(n);
+    return n == s.size();
+}
+
+inline std::string pod_get(const char* src, size_t cap, uint16_t len) {
+    return std::string(src, len < cap ? len : cap);
+}
+
+}
+
+// false if text had to be truncated (the record is still valid)
+inline bool to_pod(const Event& e, PodEvent& out) {
+    std::memset(static_cast<void*>(&out), 0, sizeof(out));
+    out.seq = e.h.seq;
+    out.ts_ns = e.h.ts_ns;
+    out.t_pub_ns = e.h.t_pub_ns;
+    out.topic = static_cast<uint8_t>(e.h.topic);
+    out.kind = static_cast<uint8_t>(e.p.index());
+    out.symbol = symbol_of(e.p);
+    bool whole = true;
+    std::visit([&](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, Tick>) {
+            out.u.tick.pq = v.pq.raw();
+            out.u.tick.qty = v.qty;
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            whole = detail::pod_put(out.u.text, PodEvent::kLogCap, v, out.text_len);
+        } else if constexpr (std::is_same_v<T, Bar>) {
+            out.u.bar.open = v.open.raw();
+            out.u.bar.close = v.close.raw();
+            out.u.bar.high = v.high.raw();
+            out.u.bar.low = v.low.raw();
+            out.u.bar.volume = v.volume;
+            out.u.bar.start_ts_ns = v.start_ts_ns;
+            out.u.bar.end_ts_ns = v.end_ts_ns;
+        } else if constexpr (std::is_same_v<T, Heartbeat>) {
+            out.u.heartbeat.t_ms = v.t_ms;
+        } else if constexpr (std::is_same_v<T, Order>) {
+            out.u.order.order_id = v.order_id;
+            out.u.order.price = v.price.raw();
+            out.u.order.qty = v.qty;
+            out.u.order.side = static_cast<uint8_t>(v.side);
+            out.u.order.type = static_cast<uint8_t>(v.type);
+        } else if constexpr (std::is_same_v<T, Trade>) {
+            out.u.trade.order_id = v.order_id;
+            out.u.trade.trade_id = v.trade_id;
+            out.u.trade.price = v.price.raw();
+            out.u.trade.qty = v.qty;
+            out.u.trade.side = static_cast<uint8_t>(v.side);
+        } else if constexpr (std::is_same_v<T, Reject>) {
+            out.u.reject.order_id = v.order_id;
+            out.u.reject.code = v.code;
+            whole = detail::pod_put(out.u.reject.reason, PodEvent::kReasonCap, v.reason, out.text_len);
+        } else if constexpr (std::is_same_v<T, BookUpdate>) {
+            out.u.book.best_bid = v.best_bid.raw();
+            out.u.book.best_ask = v.best_ask.raw();
+            out.u.book.bid_qty = v.bid_qty;
+            out.u.book.ask_qty = v.ask_qty;
+        } else if constexpr (std::is_same_v<T, RiskAlert>) {
+            out.u.risk.code = v.code;
+            whole = detail::pod_put(out.u.risk.reason, PodEvent::kReasonCap, v.reason, out.text_len);
+        }
+    }, e.p);
+    return whole;
+}
+
+// false on a record this build doesn't understand
+inline bool from_pod(const PodEvent& in, Event& out) {
+    if (in.topic >= kTopicCount || in.kind > PodEvent::KRisk) return false;
+    out.h.seq = in.seq;
+    out.h.ts_ns = in.ts_ns;
+    out.h.t_pub_ns = in.t_pub_ns;
+    out.h.topic = static_cast<Topic>(in.topic);
+    auto px = [](int64_t raw) { return Price::from_raw(raw); };
+    const SymbolId sym = in.symbol;
+    switch (in.kind) {
+        case PodEvent::None: out.p = std::monostate{}; break;
+        case PodEvent::KTick: out.p = Tick{sym, px(in.u.tick.pq), in.u.tick.qty}; break;
+        case PodEvent::KText: out.p = detail::pod_get(in.u.text, PodEvent::kLogCap, in.text_len); break;
+        case PodEvent::KBar:
+            out.p = Bar{sym, px(in.u.bar.open), px(in.u.bar.close), px(in.u.bar.high), px(in.u.bar.low),
+                        in.u.bar.volume, in.u.bar.start_ts_ns, in.u.bar.end_ts_ns};
+            break;
+        case PodEvent::KHeartbeat: out.p = Heartbeat{in.u.heartbeat.t_ms}; break;
+        case PodEvent::KOrder:
+            out.p = Order{in.u.order.order_id, sym, static_cast<Side>(in.u.order.side),
+                          static_cast<OrderType>(in.u.order.type), in.u.order.qty, px(in.u.order.price)};
+            break;
+        case PodEvent::KTrade:
+            out.p = Trade{in.u.trade.order_id, in.u.trade.trade_id, sym,
+                          static_cast<Side>(in.u.trade.side), in.u.trade.qty, px(in.u.trade.price)};
+            break;
+        case PodEvent::KReject:
+            out.p = Reject{in.u.reject.order_id, sym, in.u.reject.code,
+                           detail::pod_get(in.u.reject.reason, PodEvent::kReasonCap, in.text_len)};
+            break;
+        case PodEvent::KBook:
+            out.p = BookUpdate{sym, px(in.u.book.best_bid), px(in.u.book.best_ask), in.u.book.bid_qty, in.u.book.ask_qty};
+            break;
+        case PodEvent::KRisk:
+            out.p = RiskAlert{sym, in.u.risk.code,
+                              detail::pod_get(in.u.risk.reason, PodEvent::kReasonCap, in.text_len)};
+            break;
+    }
+    return true;
+}
+
+}
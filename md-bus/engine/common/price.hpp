@@ -0,0 +1,185 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "symbol.hpp"
+
+namespace md {
+
+// Fixed-point price: an int64 count of 1e-8 units. Compares, adds and
+// subtracts are integer ops, so there is no off-by-epsilon between a
+// limit and the last trade, and sums don't drift. One unit for every
+// symbol keeps a Price meaningful without its symbol. How finely a symbol
+// actually trades is per-symbol config (set_price_decimals()) used to
+// round feed prices and check order prices.
+//
+// The range is +-92 billion, which also covers cash amounts (Account PnL);
+// doubles outside it saturate.
+//
+// It builds implicitly from a double (rounded to the nearest unit), so
+// literals read as before: Tick{.symbol = "NIFTY", .pq = 22500.25}. It
+// does not convert back implicitly: ask for to_double() where floating
+// math is really wanted (statistics, ratios).
+class Price {
+private:
+    int64_t raw_{0};
+
+    static constexpr int64_t from_double(double v) {
+        if (v != v) return 0;
+        constexpr double kTwo63 = 9223372036854775808.0; // 2^63, exact
+        const double scaled = v * static_cast<double>(kScale) + (v < 0 ? -0.5 : 0.5);
+        if (scaled >= kTwo63) return std::numeric_limits<int64_t>::max();
+        if (scaled <= -kTwo63) return std::numeric_limits<int64_t>::min();
+        return static_cast<int64_t>(scaled);
+    }
+
+    static constexpr int64_t pow10(int n) {
+        int64_t p = 1;
+        while (n-- > 0) p *= 10;
+        return p;
+    }
+
+public:
+    static constexpr int kDecimals = 8;
+    static constexpr int64_t kScale = 100'000'000;
+
+    constexpr Price() = default;
+    // saturates at min()/max() outside the range (infinities included);
+    // NaN becomes 0. The cast of an out-of-range double is UB, so it is
+    // never reached with one.
+    constexpr Price(double v) : raw_{from_double(v)} {}
+
+    static constexpr Price from_raw(int64_t raw) {
+        Price p;
+        p.raw_ = raw;
+        return p;
+    }
+    static constexpr Price min() { return from_raw(std::numeric_limits<int64_t>::min()); }
+    static constexpr Price max() { return from_raw(std::numeric_limits<int64_t>::max()); }
+
+    constexpr int64_t raw() const { return raw_; }
+    constexpr double to_double() const { return static_cast<double>(raw_) / static_cast<double>(kScale); }
+
+    // to the nearest multiple of 10^-decimals, halves away from zero; the
+    // ends of the range (saturated values) come back unchanged
+    constexpr Price rounded(int decimals) const {
+        if (decimals >= kDecimals) return *this;
+        const int64_t step = pow10(kDecimals - (decimals < 0 ? 0 : decimals));
+        // round the remainder, so raw_ +- half can't overflow near min()/max()
+        const int64_t q = raw_ / step;
+        const int64_t r = raw_ % step;
+        if (r >= step - r) return q < max().raw_ / step ? from_raw((q + 1) * step) : *this;
+        if (-r >= step + r) return q > min().raw_ / step ? from_raw((q - 1) * step) : *this;
+        return from_raw(q * step);
+    }
+    constexpr bool on_grid(int decimals) const { return rounded(decimals).raw_ == raw_; }
+
+    friend constexpr bool operator==(Price a, Price b) { return a.raw_ == b.raw_; }
+    friend constexpr bool operator!=(Price a, Price b) { return a.raw_ != b.raw_; }
+    friend constexpr bool operator<(Price a, Price b) { return a.raw_ < b.raw_; }
+    friend constexpr bool operator<=(Price a, Price b) { return a.raw_ <= b.raw_; }
+    friend constexpr bool operator>(Price a, Price b) { return a.raw_ > b.raw_; }
+    friend constexpr bool operator>=(Price a, Price b) { return a.raw_ >= b.raw_; }
+
+    friend constexpr Price operator+(Price a, Price b) { return from_raw(a.raw_ + b.raw_); }
+    friend constexpr Price operator-(Price a, Price b) { return from_raw(a.raw_ - b.raw_); }
+    constexpr Price operator-() const { return from_raw(-raw_); }
+    constexpr Price& operator+=(Price o) { raw_ += o.raw_; return *this; }
+    constexpr Price& operator-=(Price o) { raw_ -= o.raw_; return *this; }
+    // price x quantity, e.g. notional or PnL
+    friend constexpr Price operator*(Price a, int64_t qty) { return from_raw(a.raw_ * qty); }
+    friend constexpr Price operator*(int64_t qty, Price a) { return from_raw(a.raw_ * qty); }
+};
+
+static_assert(sizeof(Price) == sizeof(int64_t));
+static_assert(Price(22500.25).raw() == 2'250'025'000'000);
+static_assert(Price(-0.015).rounded(2) == Price(-0.02));
+static_assert(Price(1e11) == Price::max() && Price(-1e11) == Price::min());
+static_assert(Price::max().rounded(2) == Price::max() && Price::min().rounded(0) == Price::min());
+
+// exact decimal text, trailing zeros trimmed: "22500.25", "-3", "0.00000001"
+inline std::string format_price(Price p) {
+    const int64_t raw = p.raw();
+    // magnitude as unsigned, so INT64_MIN doesn't overflow
+    const uint64_t mag = raw < 0 ? 0 - static_cast<uint64_t>(raw) : static_cast<uint64_t>(raw);
+    std::string s = raw < 0 ? "-" : "";
+    s += std::to_string(mag / Price::kScale);
+    uint64_t frac = mag % Price::kScale;
+    if (frac != 0) {
+        char digits[Price::kDecimals];
+        int n = Price::kDecimals;
+        while (frac % 10 == 0) { frac /= 10; --n; }
+        for (int i = n - 1; i >= 0; --i) { digits[i] = static_cast<char>('0' + frac % 10); frac /= 10; }
+        s.push_back('.');
+        s.append(digits, static_cast<size_t>(n));
+    }
+    return s;
+}
+
+// exact inverse of format_price(); also takes what std::to_string(double)
+// wrote ("22500.250000"). Digits past the 8th decimal round half up.
+// false on anything that isn't [-]digits[.digits] or doesn't fit.
+inline bool parse_price(std::string_view s, Price& out) {
+    size_t i = 0;
+    bool neg = false;
+    if (i < s.size() && (s[i] == '-' || s[i] == '+')) neg = s[i++] == '-';
+    uint64_t whole = 0;
+    size_t int_digits = 0;
+    for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i, ++int_digits) {
+        whole = whole * 10 + static_cast<uint64_t>(s[i] - '0');
+        if (whole > static_cast<uint64_t>(std::numeric_limits<int64_t>::max() / Price::kScale)) return false;
+    }
+    uint64_t frac = 0;
+    int frac_digits = 0;
+    bool round_up = false;
+    if (i < s.size() && s[i] == '.') {
+        for (++i; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i) {
+            if (frac_digits < Price::kDecimals) {
+                frac = frac * 10 + static_cast<uint64_t>(s[i] - '0');
+                ++frac_digits;
+            } else if (frac_digits == Price::kDecimals) {
+                round_up = s[i] >= '5';
+                ++frac_digits; // only the first dropped digit counts
+            }
+        }
+    }
+    if (i != s.size() || (int_digits == 0 && frac_digits == 0)) return false;
+    for (int d = frac_digits; d < Price::kDecimals; ++d) frac *= 10;
+    const uint64_t raw = whole * Price::kScale + frac + (round_up ? 1 : 0);
+    if (raw > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) return false;
+    out = Price::from_raw(neg ? -static_cast<int64_t>(raw) : static_cast<int64_t>(raw));
+    return true;
+}
+
+// Per-symbol price precision: how many decimals the symbol's prices
+// have (2 for a 0.01 tick). Unset symbols keep all 8. Lives in the
+// symbol table, so lookups are an array read.
+inline void set_price_decimals(SymbolId s, int decimals) {
+    if (decimals < 0) decimals = 0;
+    if (decimals > Price::kDecimals) decimals = Price::kDecimals;
+    SymbolTable::global().set_price_decimals(s.id(), decimals);
+}
+
+inline int price_decimals(SymbolId s) {
+    const int d = SymbolTable::global().price_decimals(s.id());
+    return d < 0 ? Price::kDecimals : d;
+}
+
+// a floating feed price on the symbol's grid
+inline Price to_price(double v, SymbolId s) {
+    return Price(v).rounded(price_decimals(s));
+}
+
+}
+
+template <>
+struct fmt::formatter<md::Price> : fmt::formatter<std::string_view> {
+    template <typename Ctx>
+    auto format(md::Price p, Ctx& ctx) const {
+        return fmt::formatter<std::string_view>::format(md::format_price(p), ctx);
+    }
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace md {
+
+// producer and consumer indices live on separate cache lines so the reactor
+// (writer) and the subscriber worker (reader) never false-share
+inline constexpr std::size_t kCacheLine = 64;
+
+inline std::size_t round_up_pow2(std::size_t n) {
+    std::size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+// Lock-free single-producer / single-consumer ring buffer.
+//  - slots are preallocated once, capacity is rounded up to a power of two
+//    so wrapping an index is a mask instead of a modulo
+//  - tail_ is only written by the producer, head_ only by the consumer
+//  - each side caches the other side's index and only re-reads it
+//    (acquire) when the ring looks full / empty
+// Non blocking on both ends; waiting is left to the caller.
+template <typename T>
+class SpscRing {
+private:
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    // consumer side
+    alignas(kCacheLine) std::atomic<std::size_t> head_{0};
+    std::size_t cached_tail_{0};
+
+    // producer side
+    alignas(kCacheLine) std::atomic<std::size_t> tail_{0};
+    std::size_t cached_head_{0};
+
+    char pad_[kCacheLine - sizeof(std::atomic<std::size_t>) - sizeof(std::size_t)];
+
+public:
+    explicit SpscRing(std::size_t capacity)
+        : capacity_{round_up_pow2(capacity ? capacity : 1)},
+          mask_{capacity_ - 1},
+          slots_{new T[capacity_]} {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // producer only
+    template <typename U>
+    bool try_push(U&& item) {
+        const std::size_t t = tail_.load(std::memory_order_relaxed);
+        if (t - cached_head_ >= capacity_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (t - cached_head_ >= capacity_) return false;
+        }
+        slots_[t & mask_] = std::forward<U>(item);
+        tail_.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only
+    bool try_pop(T& out) {
+        const std::size_t h = head_.load(std::memory_order_relaxed);
+        if (h == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (h == cached_tail_) return false;
+        }
+        out = std::move(slots_[h & mask_]);
+        head_.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // approximate when called concurrently with push/pop
+    std::size_t size() const {
+        const std::size_t h = head_.load(std::memory_order_acquire);
+        const std::size_t t = tail_.load(std::memory_order_acquire);
+        return t - h;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    std::size_t capacity() const { return capacity_; }
+};
+
+}
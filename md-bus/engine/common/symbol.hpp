@@ -0,0 +1,170 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <fmt/format.h>
+
+namespace md {
+
+// Process-wide symbol table: interns names into dense ids 0, 1, 2, ...
+// (0 is the empty name). Names are never removed, so an id stays valid
+// for the life of the process and per-symbol state can be a flat array
+// indexed by id.
+//
+// intern() is a shared-lock hash lookup (exclusive only the first time a
+// name is seen): do it at the edges (feed handlers, codecs, config), not
+// per event. name() is lock-free: names sit in fixed chunks that never
+// move.
+//
+// Ids are local to the process. Anything that leaves it (recordings,
+// shared memory) carries the name.
+//
+// Besides the name, each symbol carries a few attributes that hot paths
+// look up by id (price decimals, see price.hpp).
+class SymbolTable {
+private:
+    static constexpr size_t kChunkBits = 10;
+    static constexpr size_t kChunk = size_t{1} << kChunkBits;
+    static constexpr size_t kMaxChunks = 4096;        // 4M symbols
+
+    struct Entry {
+        std::string name;
+        std::atomic<int8_t> price_decimals{-1}; // -1: not set
+    };
+
+    std::array<std::atomic<Entry*>, kMaxChunks> chunks_{};
+    std::atomic<uint32_t> size_{0};
+
+    mutable std::shared_mutex mu_;
+    std::unordered_map<std::string_view, uint32_t> ids_; // views into chunks_
+
+    SymbolTable() { intern(std::string_view{}); }
+
+    // id < size()
+    Entry& entry(uint32_t id) const {
+        return chunks_[id >> kChunkBits].load(std::memory_order_acquire)[id & (kChunk - 1)];
+    }
+
+public:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    ~SymbolTable() {
+        for (auto& c : chunks_) delete[] c.load(std::memory_order_relaxed);
+    }
+
+    SymbolTable(const SymbolTable&) = delete;
+    SymbolTable& operator=(const SymbolTable&) = delete;
+
+    static SymbolTable& global() {
+        static SymbolTable t;
+        return t;
+    }
+
+    uint32_t intern(std::string_view name) {
+        {
+            std::shared_lock lk(mu_);
+            auto it = ids_.find(name);
+            if (it != ids_.end()) return it->second;
+        }
+        std::unique_lock lk(mu_);
+        auto it = ids_.find(name);
+        if (it != ids_.end()) return it->second;
+
+        const uint32_t id = size_.load(std::memory_order_relaxed);
+        const size_t c = id >> kChunkBits;
+        if (c >= kMaxChunks) throw std::length_error("SymbolTable full");
+        Entry* chunk = chunks_[c].load(std::memory_order_relaxed);
+        if (!chunk) {
+            chunk = new Entry[kChunk];
+            chunks_[c].store(chunk, std::memory_order_release);
+        }
+        std::string& slot = chunk[id & (kChunk - 1)].name;
+        slot.assign(name);
+        ids_.emplace(std::string_view{slot}, id);
+        size_.store(id + 1, std::memory_order_release); // publishes slot
+        return id;
+    }
+
+    // kNone if the name was never interned
+    uint32_t find(std::string_view name) const {
+        std::shared_lock lk(mu_);
+        auto it = ids_.find(name);
+        return it == ids_.end() ? kNone : it->second;
+    }
+
+    // unknown ids read as the empty name
+    const std::string& name(uint32_t id) const {
+        static const std::string empty;
+        if (id >= size_.load(std::memory_order_acquire)) return empty;
+        return entry(id).name;
+    }
+
+    // -1 if never set (or unknown id)
+    int price_decimals(uint32_t id) const {
+        if (id >= size_.load(std::memory_order_acquire)) return -1;
+        return entry(id).price_decimals.load(std::memory_order_relaxed);
+    }
+    void set_price_decimals(uint32_t id, int decimals) {
+        if (id >= size_.load(std::memory_order_acquire)) return;
+        entry(id).price_decimals.store(static_cast<int8_t>(decimals), std::memory_order_relaxed);
+    }
+
+    // ids handed out so far; every id is < size()
+    uint32_t size() const { return size_.load(std::memory_order_acquire); }
+};
+
+// An interned symbol: a uint32_t that compares, hashes and copies as one.
+// Builds from a name (interning it), so payloads still read
+//   Tick{.symbol = "NIFTY", .pq = 22500.0, .qty = 50}
+// A default SymbolId is the empty symbol, id 0.
+class SymbolId {
+private:
+    uint32_t id_{0};
+
+public:
+    constexpr SymbolId() = default;
+    SymbolId(std::string_view name) : id_{SymbolTable::global().intern(name)} {}
+    SymbolId(const char* name) : SymbolId(std::string_view{name}) {}
+    SymbolId(const std::string& name) : SymbolId(std::string_view{name}) {}
+
+    // from an id handed out by the table
+    static constexpr SymbolId from_id(uint32_t id) {
+        SymbolId s;
+        s.id_ = id;
+        return s;
+    }
+
+    constexpr uint32_t id() const { return id_; }
+    constexpr bool empty() const { return id_ == 0; }
+    const std::string& name() const { return SymbolTable::global().name(id_); }
+
+    friend constexpr bool operator==(SymbolId a, SymbolId b) { return a.id_ == b.id_; }
+    friend constexpr bool operator!=(SymbolId a, SymbolId b) { return a.id_ != b.id_; }
+    friend constexpr bool operator<(SymbolId a, SymbolId b) { return a.id_ < b.id_; }
+};
+
+static_assert(sizeof(SymbolId) == sizeof(uint32_t));
+
+}
+
+template <>
+struct std::hash<md::SymbolId> {
+    size_t operator()(md::SymbolId s) const noexcept { return s.id(); }
+};
+
+template <>
+struct fmt::formatter<md::SymbolId> : fmt::formatter<std::string_view> {
+    template <typename Ctx>
+    auto format(md::SymbolId s, Ctx& ctx) const {
+        return fmt::formatter<std::string_view>::format(s.name(), ctx);
+    }
+};
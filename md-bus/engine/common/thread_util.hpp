@@ -0,0 +1,103 @@
+#pragma once
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "log.hpp"
+
+namespace md {
+
+inline unsigned hw_threads() {
+    const unsigned n = std::thread::hardware_concurrency();
+    return n ? n : 1;
+}
+
+// All of the below are best effort: they return false if the platform, the
+// arguments or the process' privileges do not allow it.
+
+// pin a thread to one cpu
+inline bool pin_thread(std::thread::native_handle_type th, int cpu) {
+#if defined(__linux__)
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(th, sizeof(set), &set) == 0;
+#else
+    (void)th; (void)cpu;
+    return false;
+#endif
+}
+
+inline bool pin_current_thread(int cpu) {
+#if defined(__linux__)
+    return pin_thread(pthread_self(), cpu);
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// shows up in top -H, perf, gdb; linux caps it at 15 chars
+inline bool set_thread_name(std::thread::native_handle_type th, const std::string& name) {
+#if defined(__linux__)
+    return pthread_setname_np(th, name.substr(0, 15).c_str()) == 0;
+#else
+    (void)th; (void)name;
+    return false;
+#endif
+}
+
+inline bool set_current_thread_name(const std::string& name) {
+#if defined(__linux__)
+    return set_thread_name(pthread_self(), name);
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+// SCHED_FIFO at the given priority (1..99), needs CAP_SYS_NICE / rtprio;
+// priority 0 puts the thread back on SCHED_OTHER
+inline bool set_thread_fifo(std::thread::native_handle_type th, int priority) {
+#if defined(__linux__)
+    sched_param sp{};
+    sp.sched_priority = priority;
+    return pthread_setschedparam(th, priority > 0 ? SCHED_FIFO : SCHED_OTHER, &sp) == 0;
+#else
+    (void)th; (void)priority;
+    return false;
+#endif
+}
+
+// how a bus thread is set up when it starts
+struct ThreadConfig {
+    std::string name;       // empty: keep the inherited name
+    int cpu = -1;           // -1: let the kernel place it
+    int fifo_priority = 0;  // > 0: SCHED_FIFO with this priority
+};
+
+// called by the thread itself first thing; logs what it could not apply
+inline void apply_thread_config(const ThreadConfig& c) {
+#if defined(__linux__)
+    const auto self = pthread_self();
+    if (!c.name.empty() && !set_current_thread_name(c.name)) {
+        log_warn("thread '{}': failed to set name", c.name);
+    }
+    if (c.cpu >= 0 && !pin_thread(self, c.cpu)) {
+        log_warn("thread '{}': failed to pin to cpu {}", c.name, c.cpu);
+    }
+    if (c.fifo_priority > 0 && !set_thread_fifo(self, c.fifo_priority)) {
+        log_warn("thread '{}': failed to set SCHED_FIFO priority {} (needs CAP_SYS_NICE)",
+                 c.name, c.fifo_priority);
+    }
+#else
+    (void)c;
+#endif
+}
+
+}
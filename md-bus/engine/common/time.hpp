@@ -2,16 +2,29 @@
 #include <cstdint>
 #include <chrono>
 
+#include "tsc_clock.hpp"
+
 namespace md {
 
+// the clock events are stamped with; build with -DMD_TSC_CLOCK=ON to use
+// the calibrated TSC instead of steady_clock (same timeline either way)
 inline uint64_t now_ns() {
-    using namespace std::chrono;
-    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().
-    time_since_epoch()).count();
+#ifdef MD_TSC_CLOCK
+    return TscClock::instance().now_ns();
+#else
+    return steady_now_ns();
+#endif
 }
 
 inline uint64_t now_ms() {
     return now_ns() / 1'000'000ULL;
 }
 
+// Unix-epoch wall time, for timestamps other programs read (exported
+// metrics). Can jump with NTP; never use it for latencies.
+inline uint64_t wall_now_ns() {
+    using namespace std::chrono;
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count());
+}
+
 }
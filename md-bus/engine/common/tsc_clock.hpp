@@ -0,0 +1,203 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define MD_HAVE_RDTSC 1
+#endif
+
+#include "thread_util.hpp"
+
+namespace md {
+
+inline uint64_t steady_now_ns() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Nanosecond clock from the invariant TSC: one rdtsc plus a multiply,
+// instead of a clock_gettime() call (vDSO, but still ~20ns and a seqlock
+// of its own).
+//
+// Readings are on the steady_clock timeline, so they mix with steady
+// timestamps (timers, other processes) to within the calibration error.
+// The conversion is ns = ns0 + ((tsc - tsc0) * mult >> 32). A background
+// thread ("md-tsc") re-anchors it every second: the new anchor continues
+// the old line (no jumps), and the slope is picked so the clock meets
+// steady_clock again one period later. So drift never accumulates and the
+// clock stays monotonic.
+//
+// On CPUs without an invariant TSC (or non-x86) now_ns() is steady_now_ns().
+class TscClock {
+private:
+    static constexpr unsigned kShift = 32;
+    static constexpr uint64_t kPeriodNs = 1'000'000'000;     // re-anchor every second
+    static constexpr uint64_t kMaxErrorNs = 1'000'000;       // beyond that: step, don't slew
+
+    struct Sample { uint64_t tsc; uint64_t ns; };
+
+    // seqlock: odd while the calibration thread updates the params
+    std::atomic<uint32_t> gen_{0};
+    std::atomic<uint64_t> tsc0_{0};
+    std::atomic<uint64_t> ns0_{0};
+    std::atomic<uint64_t> mult_{0};
+
+    bool usable_{false};
+    Sample first_{};                       // long-run rate is measured from here
+    std::atomic<int64_t> last_error_ns_{0};
+    std::atomic<uint64_t> recalibrations_{0};
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool stop_{false};
+    std::thread th_;
+
+    static bool invariant_tsc() {
+#ifdef MD_HAVE_RDTSC
+        unsigned a = 0, b = 0, c = 0, d = 0;
+        if (!__get_cpuid(0x80000000u, &a, &b, &c, &d) || a < 0x80000007u) return false;
+        __get_cpuid(0x80000007u, &a, &b, &c, &d);
+        return (d & (1u << 8)) != 0;
+#else
+        return false;
+#endif
+    }
+
+    // a (tsc, steady) pair read as close together as we can: keep the
+    // tightest of a few tries, take the tsc midpoint
+    static Sample sample() {
+        Sample best{};
+        uint64_t best_window = ~0ULL;
+        for (int i = 0; i < 8; ++i) {
+            const uint64_t a = ticks();
+            const uint64_t ns = steady_now_ns();
+            const uint64_t b = ticks();
+            if (b - a < best_window) {
+                best_window = b - a;
+                best = Sample{a + (b - a) / 2, ns};
+            }
+        }
+        return best;
+    }
+
+    static uint64_t mult_for(uint64_t ns, uint64_t ticks) {
+        return ticks ? (uint64_t)(((unsigned __int128)ns << kShift) / ticks) : 0;
+    }
+
+    static uint64_t convert(uint64_t tsc, uint64_t tsc0, uint64_t ns0, uint64_t mult) {
+        // tsc can be a hair behind tsc0: rdtsc isn't ordered after the loads
+        if (tsc >= tsc0) return ns0 + (uint64_t)(((unsigned __int128)(tsc - tsc0) * mult) >> kShift);
+        return ns0 - (uint64_t)(((unsigned __int128)(tsc0 - tsc) * mult) >> kShift);
+    }
+
+    void publish(uint64_t tsc0, uint64_t ns0, uint64_t mult) {
+        const uint32_t g = gen_.load(std::memory_order_relaxed);
+        gen_.store(g + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        tsc0_.store(tsc0, std::memory_order_relaxed);
+        ns0_.store(ns0, std::memory_order_relaxed);
+        mult_.store(mult, std::memory_order_relaxed);
+        gen_.store(g + 2, std::memory_order_release);
+    }
+
+    void recalibrate() {
+        const Sample s = sample();
+        const uint64_t cur = convert(s.tsc, tsc0_.load(std::memory_order_relaxed),
+                                     ns0_.load(std::memory_order_relaxed),
+                                     mult_.load(std::memory_order_relaxed));
+        const int64_t err = (int64_t)(cur - s.ns);
+        last_error_ns_.store(err, std::memory_order_relaxed);
+        recalibrations_.fetch_add(1, std::memory_order_relaxed);
+
+        // ticks per period at the long-run rate, the best estimate we have
+        const uint64_t run_ns = s.ns - first_.ns;
+        const uint64_t run_ticks = s.tsc - first_.tsc;
+        if (run_ns == 0 || run_ticks == 0) return;
+        const uint64_t period_ticks = (uint64_t)((unsigned __int128)kPeriodNs * run_ticks / run_ns);
+
+        if (err > (int64_t)kMaxErrorNs || err < -(int64_t)kMaxErrorNs) {
+            // suspend/resume or a steady_clock step: start over from here
+            first_ = s;
+            publish(s.tsc, s.ns, mult_for(kPeriodNs, period_ticks));
+            return;
+        }
+        // continue from where the old line is now, aim at steady one period on
+        publish(s.tsc, cur, mult_for(s.ns + kPeriodNs - cur, period_ticks));
+    }
+
+    void loop() {
+        set_current_thread_name("md-tsc");
+        std::unique_lock lk(mu_);
+        while (!cv_.wait_for(lk, std::chrono::nanoseconds(kPeriodNs), [this] { return stop_; })) {
+            lk.unlock();
+            recalibrate();
+            lk.lock();
+        }
+    }
+
+    TscClock() {
+        usable_ = invariant_tsc();
+        if (!usable_) return;
+        // first estimate over a few ms; the thread refines it from there
+        first_ = sample();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        const Sample s = sample();
+        publish(s.tsc, s.ns, mult_for(s.ns - first_.ns, s.tsc - first_.tsc));
+        th_ = std::thread([this] { loop(); });
+    }
+
+public:
+    ~TscClock() {
+        {
+            std::scoped_lock lk(mu_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        if (th_.joinable()) th_.join();
+    }
+
+    TscClock(const TscClock&) = delete;
+    TscClock& operator=(const TscClock&) = delete;
+
+    // the first call calibrates (~10ms): touch it at startup, not on a hot path
+    static TscClock& instance() {
+        static TscClock c;
+        return c;
+    }
+
+    static uint64_t ticks() {
+#ifdef MD_HAVE_RDTSC
+        return __rdtsc();
+#else
+        return steady_now_ns();
+#endif
+    }
+
+    uint64_t now_ns() const {
+        if (!usable_) return steady_now_ns();
+        for (;;) {
+            const uint32_t g = gen_.load(std::memory_order_acquire);
+            const uint64_t tsc0 = tsc0_.load(std::memory_order_relaxed);
+            const uint64_t ns0 = ns0_.load(std::memory_order_relaxed);
+            const uint64_t mult = mult_.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((g & 1) == 0 && gen_.load(std::memory_order_relaxed) == g) {
+                return convert(ticks(), tsc0, ns0, mult);
+            }
+        }
+    }
+
+    bool usable() const { return usable_; }
+    double ns_per_tick() const { return (double)mult_.load(std::memory_order_relaxed) / (double)(1ULL << kShift); }
+    // TSC minus steady at the last re-anchor
+    int64_t last_error_ns() const { return last_error_ns_.load(std::memory_order_relaxed); }
+    uint64_t recalibrations() const { return recalibrations_.load(std::memory_order_relaxed); }
+};
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace md {
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// how a consumer waits for work
+//  BusySpin  : pause-loop on the predicate, never sleeps. Lowest wake-up
+//              latency, burns a whole core: pinned hot paths only
+//  SpinYield : spin a little, then sched_yield() in a loop. Gives the core
+//              away to other runnable threads but never blocks
+//  SpinPark  : spin, yield, then block on the condition variable (default)
+enum class WaitStrategy : uint8_t { BusySpin = 0, SpinYield = 1, SpinPark = 2 };
+
+inline const char* to_string(WaitStrategy w) {
+    switch (w) {
+        case WaitStrategy::BusySpin : return "BUSY_SPIN";
+        case WaitStrategy::SpinYield : return "SPIN_YIELD";
+        case WaitStrategy::SpinPark : return "SPIN_PARK";
+    }
+    return "UNKNOWN";
+}
+
+// Doorbell
+// --------
+// Lets a consumer park until a producer rings, without the producer paying
+// for a mutex + notify on every push. ring() is a fence and one relaxed load
+// unless somebody is actually asleep.
+//
+// Consumer:  bell.wait([&]{ return !ring.empty() || stopping; });
+// Producer:  ring.try_push(x); bell.ring();
+//
+// Consumers that never park (BusySpin, SpinYield) don't count as sleepers,
+// so ringing for them stays a fence and a load.
+class Doorbell {
+private:
+    static constexpr int kSpin = 128;
+    static constexpr int kYield = 16;
+
+    std::atomic<uint32_t> sleepers_{0};
+    std::mutex mu_;
+    std::condition_variable cv_;
+
+public:
+    void ring() {
+        // pairs with the fence in wait(): either we see the sleeper, or the
+        // sleeper sees whatever we published before ringing
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) == 0) return;
+        { std::lock_guard<std::mutex> lk(mu_); }
+        cv_.notify_all();
+    }
+
+    template <typename Pred>
+    void wait(Pred ready, WaitStrategy how = WaitStrategy::SpinPark) {
+        if (how == WaitStrategy::BusySpin) {
+            while (!ready()) cpu_relax();
+            return;
+        }
+        for (int i = 0; i < kSpin; ++i) {
+            if (ready()) return;
+            cpu_relax();
+        }
+        if (how == WaitStrategy::SpinYield) {
+            while (!ready()) std::this_thread::yield();
+            return;
+        }
+        for (int i = 0; i < kYield; ++i) {
+            if (ready()) return;
+            std::this_thread::yield();
+        }
+        sleepers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lk(mu_);
+            cv_.wait(lk, ready);
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+};
+
+}
@@ -0,0 +1,62 @@
+// engine/examples/bench_clock.cpp
+//
+// What a timestamp costs: steady_clock::now() vs raw rdtsc vs the
+// calibrated TscClock, then how far the TSC clock wanders from
+// steady_clock over a few seconds (it re-anchors once a second).
+#include <fmt/core.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+#include "../common/log.hpp"
+#include "../common/tsc_clock.hpp"
+
+namespace {
+
+constexpr int kCalls = 10'000'000;
+constexpr int kDriftSeconds = 5;
+
+template <typename F>
+double ns_per_call(F&& f) {
+    uint64_t sink = 0;
+    const uint64_t t0 = md::steady_now_ns();
+    for (int i = 0; i < kCalls; ++i) sink += f();
+    const uint64_t t1 = md::steady_now_ns();
+    if (sink == 42) std::abort(); // keep the calls
+    return (double)(t1 - t0) / kCalls;
+}
+
+}
+
+int main() {
+    md::set_log_level(md::LogLevel::Warn);
+
+    auto& tsc = md::TscClock::instance();
+    if (!tsc.usable()) fmt::print("no invariant TSC: TscClock falls back to steady_clock\n");
+    else fmt::print("TSC: {:.4f} ns/tick ({:.3f} GHz)\n\n", tsc.ns_per_tick(), 1.0 / tsc.ns_per_tick());
+
+    fmt::print("{:<16} {:>10}\n", "clock", "ns/call");
+    fmt::print("{:<16} {:>10.2f}\n", "steady_clock", ns_per_call([] { return md::steady_now_ns(); }));
+    fmt::print("{:<16} {:>10.2f}\n", "rdtsc", ns_per_call([] { return md::TscClock::ticks(); }));
+    fmt::print("{:<16} {:>10.2f}\n", "TscClock", ns_per_call([&] { return tsc.now_ns(); }));
+
+    fmt::print("\n{:>4} {:>12} {:>12} {:>8}\n", "s", "tsc-steady", "max |diff|", "anchors");
+    int64_t worst = 0;
+    for (int s = 1; s <= kDriftSeconds; ++s) {
+        const uint64_t until = md::steady_now_ns() + 1'000'000'000ULL;
+        int64_t diff = 0;
+        while (md::steady_now_ns() < until) {
+            // bracket the steady read with two TSC reads, compare to the middle
+            const uint64_t a = tsc.now_ns();
+            const uint64_t st = md::steady_now_ns();
+            const uint64_t b = tsc.now_ns();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            if (b - a > 1'000) continue; // preempted in between, says nothing
+            diff = (int64_t)(a / 2 + b / 2) - (int64_t)st;
+            worst = std::max(worst, diff < 0 ? -diff : diff);
+        }
+        fmt::print("{:>4} {:>12} {:>12} {:>8}   (ns)\n", s, diff, worst, tsc.recalibrations());
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+// engine/examples/bench_fanout.cpp
+//
+// Fan-out cost: one publisher, S MD_TICK subscribers, per-subscriber copies
+// vs shared_events (one pooled envelope per event, subscribers get refs).
+// Symbols are interned ids, so a copy is the variant plus a small memcpy.
+#include <fmt/core.h>
+#include <atomic>
+#include <thread>
+
+#include "../bus/bus.hpp"
+#include "../common/event.hpp"
+#include "../common/log.hpp"
+#include "../common/time.hpp"
+
+namespace {
+
+constexpr int kEvents = 200'000;
+
+double run(int subs, bool shared) {
+    md::EventBus bus(md::BusOptions{.ingress_cap = 65536, .per_sub_cap = 65536,
+                                    .shared_events = shared});
+    bus.set_perf_enabled(false);
+
+    std::atomic<uint64_t> got{0};
+    for (int i = 0; i < subs; ++i) {
+        bus.subscribe(md::Topic::MD_TICK, [&](const md::Event&){
+            got.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    const uint64_t expected = static_cast<uint64_t>(kEvents) * subs;
+
+    md::Header h{};
+    h.topic = md::Topic::MD_TICK;
+    const md::Tick t{.symbol = "NSE:NIFTY24JUN22500CE", .pq = 101.5, .qty = 50};
+    const uint64_t t0 = md::now_ns();
+    for (int i = 0; i < kEvents; ++i) bus.publish(md::Event{.h = h, .p = t});
+    while (got.load(std::memory_order_relaxed) < expected) std::this_thread::yield();
+    const uint64_t t1 = md::now_ns();
+    bus.stop();
+    return (double)kEvents * 1e9 / (double)(t1 - t0);
+}
+
+}
+
+int main() {
+    md::set_log_level(md::LogLevel::Warn);
+
+    fmt::print("{:>6} {:>18} {:>18}\n", "subs", "copies ev/s", "shared ev/s");
+    for (int subs : {1, 2, 4, 8, 16}) {
+        const double a = run(subs, false);
+        const double b = run(subs, true);
+        fmt::print("{:>6} {:>18.0f} {:>18.0f}\n", subs, a, b);
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+// engine/examples/bench_publish.cpp
+//
+// Publisher scaling benchmark: N threads (1..16) hammer the bus ingress.
+//  1) raw queue: MpscRing vs the old mutex BoundedQueue, one consumer
+//  2) full bus: EventBus::publish with one MD_TICK subscriber counting
+//  3) same, but each producer uses publish_batch with 64 events per call
+//  4) single publish again, on 4 reactor shards (64 symbols spread over them)
+#include <fmt/core.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "../bus/bus.hpp"
+#include "../common/bounded_queue.hpp"
+#include "../common/event.hpp"
+#include "../common/log.hpp"
+#include "../common/mpsc_ring.hpp"
+#include "../common/time.hpp"
+
+namespace {
+
+constexpr uint64_t kEventsPerThread = 200'000;
+
+template <typename PushFn, typename PopFn>
+double run_raw(int producers, PushFn push, PopFn pop) {
+    const uint64_t total = kEventsPerThread * producers;
+    std::atomic<bool> go{false};
+    std::vector<std::thread> ths;
+    for (int p = 0; p < producers; ++p) {
+        ths.emplace_back([&, p]{
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (uint64_t i = 0; i < kEventsPerThread; ++i) {
+                push(static_cast<uint64_t>(p) << 32 | i);
+            }
+        });
+    }
+    const uint64_t t0 = md::now_ns();
+    go.store(true, std::memory_order_release);
+    uint64_t got = 0;
+    uint64_t v = 0;
+    while (got < total) {
+        if (pop(v)) ++got;
+        else std::this_thread::yield();
+    }
+    const uint64_t t1 = md::now_ns();
+    for (auto& t : ths) t.join();
+    return (double)total * 1e9 / (double)(t1 - t0);
+}
+
+double run_bus(int producers, size_t batch, size_t shards = 1) {
+    md::EventBus bus(md::BusOptions{.ingress_cap = 65536, .per_sub_cap = 65536,
+                                    .reactor_shards = shards});
+    bus.set_perf_enabled(false);
+    const uint64_t total = kEventsPerThread * producers;
+    std::atomic<uint64_t> got{0};
+    auto sub = bus.subscribe(md::Topic::MD_TICK, [&](const md::Event&){
+        got.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::atomic<bool> go{false};
+    std::vector<std::thread> ths;
+    for (int p = 0; p < producers; ++p) {
+        ths.emplace_back([&]{
+            md::Header h{};
+            h.topic = md::Topic::MD_TICK;
+            std::vector<md::Tick> ticks;
+            for (int s = 0; s < 64; ++s) {
+                ticks.push_back(md::Tick{.symbol = fmt::format("SYM{}", s), .pq = 22500.0, .qty = 1});
+            }
+            std::vector<md::Event> evs;
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            if (batch <= 1) {
+                for (uint64_t i = 0; i < kEventsPerThread; ++i) {
+                    bus.publish(md::Event{.h = h, .p = ticks[i & 63]});
+                }
+                return;
+            }
+            for (uint64_t i = 0; i < kEventsPerThread; i += batch) {
+                evs.clear();
+                for (size_t k = 0; k < batch; ++k) evs.push_back(md::Event{.h = h, .p = ticks[(i + k) & 63]});
+                bus.publish_batch(evs.data(), evs.size());
+            }
+        });
+    }
+    const uint64_t t0 = md::now_ns();
+    go.store(true, std::memory_order_release);
+    for (auto& t : ths) t.join();
+    while (got.load(std::memory_order_relaxed) < total) std::this_thread::yield();
+    const uint64_t t1 = md::now_ns();
+
+    bus.unsubscribe(sub);
+    bus.stop();
+    return (double)total * 1e9 / (double)(t1 - t0);
+}
+
+}
+
+int main() {
+    md::set_log_level(md::LogLevel::Warn);
+
+    fmt::print("{:>10} {:>16} {:>16} {:>16} {:>16} {:>16}\n",
+               "producers", "mpsc_ring ev/s", "bounded_q ev/s", "bus ev/s", "bus batch ev/s", "bus 4sh ev/s");
+    for (int n : {1, 2, 4, 8, 16}) {
+        md::MpscRing<uint64_t> ring(65536);
+        const double r = run_raw(n,
+            [&](uint64_t v){ while (!ring.try_push(v)) std::this_thread::yield(); },
+            [&](uint64_t& v){ return ring.try_pop(v); });
+
+        md::BoundedQueue<uint64_t> bq(65536);
+        const double b = run_raw(n,
+            [&](uint64_t v){ bq.push(v); },
+            [&](uint64_t& v){ return bq.try_pop(v); });
+
+        const double e = run_bus(n, 1);
+        const double eb = run_bus(n, 64);
+        const double es = run_bus(n, 1, 4);
+        fmt::print("{:>10} {:>16.0f} {:>16.0f} {:>16.0f} {:>16.0f} {:>16.0f}\n", n, r, b, e, eb, es);
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+// engine/examples/bench_shm.cpp
+//
+// Cross-process latency over a ShmRing: the parent writes ticks stamped
+// with now_ns() (steady_clock timeline in both processes), a forked
+// child busy-polls its own reader and records now - t_pub per event.
+// Writes are paced so this measures hand-off latency, not queueing. Give
+// both processes their own core (taskset / isolcpus) for meaningful numbers.
+#include <fmt/core.h>
+#include <cstdio>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../common/event.hpp"
+#include "../common/log.hpp"
+#include "../common/metrics.hpp"
+#include "../common/time.hpp"
+#include "../ipc/shm_ring.hpp"
+
+namespace {
+
+constexpr int kEvents = 200'000;
+constexpr uint64_t kGapNs = 2'000; // between writes
+const char* kRing = "md-bench-shm";
+
+int child() {
+    md::ShmRing ring;
+    if (!ring.open(kRing)) return 2;
+    md::ShmReader reader(ring);
+    md::LatencyHistogram lat;
+    md::ShmEvent rec;
+    int got = 0;
+    while (got < kEvents) {
+        if (reader.read(rec) != md::ShmReader::Read::Ok) {
+            md::cpu_relax();
+            continue;
+        }
+        const uint64_t now = md::now_ns();
+        lat.record(now >= rec.t_pub_ns ? now - rec.t_pub_ns : 0);
+        ++got;
+    }
+    const auto s = md::summarize(lat);
+    fmt::print("{:>10} {:>8} {:>8} {:>8} {:>8} {:>10} {:>8}\n",
+               "events", "min", "p50", "p95", "p99", "max", "lost");
+    fmt::print("{:>10} {:>8} {:>8} {:>8} {:>8} {:>10} {:>8}   (ns)\n",
+               s.count, s.min, s.p50, s.p95, s.p99, s.max, reader.lost());
+    std::fflush(stdout); // _exit() skips stdio cleanup
+    return 0;
+}
+
+}
+
+int main() {
+    md::set_log_level(md::LogLevel::Warn);
+
+    md::ShmRing ring;
+    if (!ring.create(kRing, 1 << 16, /*replace=*/true)) return 1; // may be left by a killed run
+    md::ShmWriter writer(ring);
+
+    const pid_t pid = ::fork();
+    if (pid < 0) return 1;
+    if (pid == 0) ::_exit(child());
+
+    // wait for the child's reader to register before writing
+    auto* h = ring.header();
+    while (h->readers[0].pid.load(std::memory_order_acquire) == 0) md::cpu_relax();
+
+    md::ShmEvent rec;
+    md::Event ev;
+    ev.h.topic = md::Topic::MD_TICK;
+    ev.p = md::Tick{.symbol = "NIFTY", .pq = 22500.0, .qty = 50};
+    md::to_shm(ev, rec);
+    for (int i = 0; i < kEvents; ++i) {
+        const uint64_t t = md::now_ns();
+        rec.seq = static_cast<uint64_t>(i);
+        rec.ts_ns = rec.t_pub_ns = t;
+        writer.write(rec);
+        while (md::now_ns() - t < kGapNs) md::cpu_relax();
+    }
+
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
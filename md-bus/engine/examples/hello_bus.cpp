@@ -3,6 +3,7 @@
 
 #include "../bus/bus.hpp"
 #include "../common/event.hpp"
+#include "../io/metrics_exporter.hpp"
 #include "../io/timer.hpp"
 #include "../record/recorder.hpp"
 #include "../common/event_io.hpp"
@@ -33,11 +34,12 @@ int main() {
                static_cast<int>(e.h.topic));
     });
 
+    // monitor only: never let it hold back the tick/log subscribers
     auto sub_all = bus.subscribe_all([](const md::Event e){
       md::log_info("[MON ] seq = {} topic = {}\n",
                 e.h.seq,
                 static_cast<int>(e.h.topic));
-    });
+    }, md::SubOptions{.overflow = md::OverflowPolicy::DropOldest, .capacity = 256, .name = "monitor"});
 
     // Recorder subscription to log all events to file
     auto sub_rec = bus.subscribe_all([&recorder](const md::Event& e){
@@ -52,6 +54,13 @@ int main() {
         }
     ); hb_timer.start();
 
+    // bus + recorder counters to logs/md_metrics.prom, once a second
+    md::MetricsRegistry metrics;
+    metrics.add("bus", [&bus](md::MetricSet& m){ bus.collect_metrics(m); });
+    metrics.add("recorder", [&recorder](md::MetricSet& m){ recorder.collect_metrics(m); });
+    md::MetricsExporter exporter(metrics, md::ExportOptions{});
+    exporter.start();
+
   for (int i = 0; i < 50; ++i) {
     md::Tick t{
         .symbol = "NIFTY", 
@@ -73,6 +82,7 @@ int main() {
 
   std::this_thread::sleep_for(std::chrono::milliseconds(1));
   hb_timer.stop();
+  exporter.stop();
   bus.unsubscribe(sub_hb);
   bus.unsubscribe(sub_all);
   bus.unsubscribe(sub_ticks);
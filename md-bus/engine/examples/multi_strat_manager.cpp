@@ -1,6 +1,4 @@
 #include <fmt/core.h>
-#include <thread>
-#include <chrono>
 
 #include "../bus/bus.hpp"
 #include "../common/event.hpp"
@@ -15,9 +13,9 @@
 #include "../strategy/strategy_manager.hpp"
 
 int main() {
-    using namespace std::chrono_literals;
-
-    md::EventBus bus(1024, 1024);
+    // backtest: no threads, every callback runs inside publish(), so the
+    // run is deterministic and nothing needs time to drain
+    md::EventBus bus(md::BusOptions{.exec = md::ExecMode::Inline});
     static constexpr uint64_t NS_PER_10MS = 10'000'000ULL;
     md::BarBuilder bar_builder(bus, NS_PER_10MS);
 
@@ -60,10 +58,7 @@ int main() {
     filter.filter_by_symbol = false;
     replayer.set_filter(filter);
     replayer.replay_fast(bus);
-    std::this_thread::sleep_for(200ms);
-
     bar_builder.flush_all();
-    std::this_thread::sleep_for(100ms);
 
     strat_mom1.finalize();
     strat_mom2.finalize();
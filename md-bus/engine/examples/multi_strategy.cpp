@@ -17,24 +17,24 @@
 class TradingThresholdStrategy : public md::IStrategy {
 private :
     md::Account& account_;
-    double threshold_;
+    md::Price threshold_;
     int qty_;
-    double sl_offset_;
-    double tp_offset_;
-    double sl_level_{0.0};
-    double tp_level_{0.0};
+    md::Price sl_offset_;
+    md::Price tp_offset_;
+    md::Price sl_level_;
+    md::Price tp_level_;
 
-    double last_pq_ {0.0};
+    md::Price last_pq_;
     uint64_t last_ts_ns_ {0};
 
 public : 
-    TradingThresholdStrategy(md::Account & account, double threshold,
-                             int qty, double stop_loss_offset, 
-                             double take_profit_offset)
+    TradingThresholdStrategy(md::Account & account, md::Price threshold,
+                             int qty, md::Price stop_loss_offset, 
+                             md::Price take_profit_offset)
         :account_{account}, threshold_{threshold}, qty_{qty}, sl_offset_{stop_loss_offset}, tp_offset_{take_profit_offset} {}
 
     void on_tick(const md::Tick& t, const md::Event& e) override {
-        const double pq = t.pq;
+        const md::Price pq = t.pq;
         last_pq_ = pq;
         last_ts_ns_ = e.h.ts_ns;
 
@@ -125,10 +125,10 @@ public :
          band_(band),
          qty_(qty) {}
     void on_tick(const md::Tick& t, const md::Event& e) override {
-        const double pq = t.pq;
+        const double pq = t.pq.to_double(); // the rolling mean is floating math
         last_pq_ = pq;
         last_ts_ns_ = e.h.ts_ns;
-        account_.update_equity(pq);
+        account_.update_equity(t.pq);
         prices_.push_back(pq);
         if(prices_.size() > window_) {
             prices_.pop_front();
@@ -143,7 +143,7 @@ public :
 
         if(!account_.has_open_position()) {
             if(diff < -band_) {
-                account_.open_long(t.symbol, qty_, pq, e.h.ts_ns);
+                account_.open_long(t.symbol, qty_, t.pq, e.h.ts_ns);
                 md::log_info("[STRAT2] ENTER LONG (MR) sym={} pq={} avg={:.2f} diff={:.2f}\n",
                            t.symbol, pq, avg, diff);
             }
@@ -153,7 +153,7 @@ public :
             const md::Position& pos = account_.position();
             md::log_info("[STRAT2] EXIT LONG (MR) sym={} pq={} avg={:.2f} diff={:.2f}\n",
                        pos.symbol, pq, avg, diff);
-            account_.close_position(pq, e.h.ts_ns, md::ExitReason::Threshold);
+            account_.close_position(t.pq, e.h.ts_ns, md::ExitReason::Threshold);
             return ;
         }
     }
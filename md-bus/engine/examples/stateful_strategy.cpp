@@ -18,24 +18,24 @@
 class TradingThresholdStrategy : public md::IStrategy {
 private :
     md::Account& account_;
-    double threshold_;
+    md::Price threshold_;
     int qty_;
-    double sl_offset_;
-    double tp_offset_;
-    double sl_level_{0.0};
-    double tp_level_{0.0};
+    md::Price sl_offset_;
+    md::Price tp_offset_;
+    md::Price sl_level_;
+    md::Price tp_level_;
 
-    double last_pq_ {0.0};
+    md::Price last_pq_;
     uint64_t last_ts_ns_ {0};
 
 public : 
-    TradingThresholdStrategy(md::Account & account, double threshold,
-                             int qty, double stop_loss_offset, 
-                             double take_profit_offset)
+    TradingThresholdStrategy(md::Account & account, md::Price threshold,
+                             int qty, md::Price stop_loss_offset, 
+                             md::Price take_profit_offset)
         :account_{account}, threshold_{threshold}, qty_{qty}, sl_offset_{stop_loss_offset}, tp_offset_{take_profit_offset} {}
 
     void on_tick(const md::Tick& t, const md::Event& e) override {
-        const double pq = t.pq;
+        const md::Price pq = t.pq;
         last_pq_ = pq;
         last_ts_ns_ = e.h.ts_ns;
 
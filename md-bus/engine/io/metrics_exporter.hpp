@@ -0,0 +1,175 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../common/log.hpp"
+#include "../common/metrics_export.hpp"
+#include "../common/thread_util.hpp"
+#include "../common/time.hpp"
+
+namespace md {
+
+enum class ExportFormat : uint8_t {
+    Prometheus, // text exposition format, the whole snapshot each time
+    JsonLines,  // one JSON object per snapshot
+};
+
+enum class ExportTarget : uint8_t {
+    File,       // Prometheus: rewritten in place (tmp + rename), JsonLines: appended
+    UnixSocket, // connect to a listening AF_UNIX stream socket and write to it
+};
+
+struct ExportOptions {
+    ExportFormat format = ExportFormat::Prometheus;
+    ExportTarget target = ExportTarget::File;
+    std::string path = "logs/md_metrics.prom"; // file or socket path
+    std::chrono::milliseconds interval{1000};
+    ThreadConfig thread{.name = "md-metrics"};
+};
+
+// collects a MetricsRegistry every `interval` on its own thread and writes
+// the result out; nothing here runs on a bus thread. A failed write is
+// logged once and retried at the next tick (sockets reconnect).
+class MetricsExporter {
+private:
+    const MetricsRegistry& reg_;
+    ExportOptions opts_;
+
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool stop_{false};
+    std::thread th_;
+
+    int fd_{-1};              // UnixSocket only, exporter thread only
+    bool failing_{false};     // last write failed, don't log every tick
+    std::atomic<uint64_t> exports_{0};
+    std::atomic<uint64_t> failures_{0};
+
+    bool write_file(const std::string& text){
+        if(opts_.format == ExportFormat::JsonLines){
+            std::ofstream out(opts_.path, std::ios::out | std::ios::app);
+            out << text;
+            return static_cast<bool>(out);
+        }
+        // readers (node_exporter textfile collector, tail) never see half a snapshot
+        const std::string tmp = opts_.path + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::out | std::ios::trunc);
+            out << text;
+            if(!out) return false;
+        }
+        return std::rename(tmp.c_str(), opts_.path.c_str()) == 0;
+    }
+
+    bool connect_socket(){
+        sockaddr_un addr{};
+        if(opts_.path.size() >= sizeof(addr.sun_path)) return false;
+        fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if(fd_ < 0) return false;
+        addr.sun_family = AF_UNIX;
+        std::memcpy(addr.sun_path, opts_.path.c_str(), opts_.path.size() + 1);
+        if(::connect(fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0){
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+        return true;
+    }
+
+    bool write_socket(const std::string& text){
+        if(fd_ < 0 && !connect_socket()) return false;
+        size_t off = 0;
+        while(off < text.size()){
+            const ssize_t n = ::send(fd_, text.data() + off, text.size() - off, MSG_NOSIGNAL);
+            if(n <= 0){
+                ::close(fd_);
+                fd_ = -1;
+                return false;
+            }
+            off += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    void run(){
+        apply_thread_config(opts_.thread);
+        std::unique_lock lk(mu_);
+        while(!stop_){
+            lk.unlock();
+            export_now();
+            lk.lock();
+            cv_.wait_for(lk, opts_.interval, [this]{ return stop_; });
+        }
+        lk.unlock();
+        export_now(); // final values on the way out
+    }
+
+public:
+    MetricsExporter(const MetricsRegistry& reg, ExportOptions opts)
+        : reg_{reg}, opts_{std::move(opts)} {}
+
+    ~MetricsExporter(){ stop(); }
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    void start(){
+        if(th_.joinable()) return;
+        {
+            std::scoped_lock lk(mu_);
+            stop_ = false;
+        }
+        th_ = std::thread([this]{ run(); });
+        log_info("MetricsExporter: {} to '{}' every {} ms",
+                 opts_.format == ExportFormat::Prometheus ? "prometheus" : "json lines",
+                 opts_.path, opts_.interval.count());
+    }
+
+    void stop(){
+        {
+            std::scoped_lock lk(mu_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        if(th_.joinable()) th_.join();
+        if(fd_ >= 0){
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    // one collection + write, on the calling thread (the exporter thread
+    // when started; don't call concurrently with it)
+    bool export_now(){
+        const MetricSet set = reg_.collect();
+        const std::string text = opts_.format == ExportFormat::Prometheus
+                                     ? format_prometheus(set)
+                                     : format_json_line(set, wall_now_ns());
+        const bool ok = opts_.target == ExportTarget::File ? write_file(text) : write_socket(text);
+        if(ok){
+            exports_.fetch_add(1, std::memory_order_relaxed);
+            failing_ = false;
+        }else{
+            failures_.fetch_add(1, std::memory_order_relaxed);
+            if(!failing_) log_warn("MetricsExporter: failed to write to '{}', will retry", opts_.path);
+            failing_ = true;
+        }
+        return ok;
+    }
+
+    uint64_t exports() const { return exports_.load(std::memory_order_relaxed); }
+    uint64_t failures() const { return failures_.load(std::memory_order_relaxed); }
+};
+
+}
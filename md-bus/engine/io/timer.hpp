@@ -4,6 +4,8 @@
 #include<functional>
 #include<thread>
 
+#include "../common/thread_util.hpp"
+
 namespace md {
 
 using Clock = std::chrono::steady_clock;
@@ -28,6 +30,7 @@ public:
         }
 
         worker_ = std::thread([this]{
+            set_current_thread_name("md-timer");
             while(running_.load(std::memory_order_relaxed)){
                 auto next = Clock::now() + period_;
                 fn_();
@@ -0,0 +1,209 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include "../common/event.hpp"
+
+namespace md {
+
+// Fixed-layout, trivially copyable event record for shared memory: no
+// pointers, no std::string, same bytes in every process. Symbols travel
+// by name (SymbolIds are per process) and are interned again on the way
+// in. Names and text (LOG message, Reject/RiskAlert reason) are stored
+// inline and truncated to fit; to_shm() says when that happened.
+struct ShmEvent {
+    static constexpr size_t kSymbolCap = 32;
+    static constexpr size_t kTextCap = 144;
+
+    // payload kinds, = Payload variant index
+    enum Kind : uint8_t {
+        None = 0, KTick, KText, KBar, KHeartbeat, KOrder, KTrade, KReject, KBook, KRisk,
+    };
+
+    uint64_t seq;
+    uint64_t ts_ns;
+    uint64_t t_pub_ns;
+    uint8_t topic;
+    uint8_t kind;
+    uint8_t symbol_len;
+    uint8_t pad0;
+    uint16_t text_len;
+    uint16_t pad1;
+
+    // prices are Price::raw()
+    union {
+        struct { int64_t pq; uint32_t qty; } tick;
+        struct { int64_t open, close, high, low; int32_t volume; uint32_t pad; } bar; // start/end below
+        struct { uint64_t t_ms; } heartbeat;
+        struct { uint64_t order_id; int64_t price; int32_t qty; uint8_t side, type; } order;
+        struct { uint64_t order_id, trade_id; int64_t price; int32_t qty; uint8_t side; } trade;
+        struct { uint64_t order_id; int32_t code; } reject;
+        struct { int64_t best_bid, best_ask; int32_t bid_qty, ask_qty; } book;
+        struct { int32_t code; } risk;
+    } u;
+
+    char symbol[kSymbolCap];
+    // text, or for bars the start/end timestamps
+    union {
+        char text[kTextCap];
+        struct { uint64_t start_ts_ns, end_ts_ns; } bar_ts;
+    } t;
+};
+
+static_assert(std::is_trivially_copyable_v<ShmEvent>, "ShmEvent is memcpy'd across processes");
+static_assert(sizeof(ShmEvent) == 248, "ShmEvent layout is shared between processes");
+static_assert(ShmEvent::KRisk + 1 == std::variant_size_v<Payload>, "ShmEvent::Kind out of sync with Payload");
+
+namespace detail {
+
+template <typename Len>
+inline bool shm_put(char* dst, size_t cap, const std::string& s, Len& len_out) {
+    const size_t n = s.size() < cap ? s.size() : cap;
+    std::memcpy(dst, s.data(), n);
+    len_out = static_cast<Len>(n);
+    return n == s.size();
+}
+
+}
+
+// false if a symbol or text had to be truncated (the record is still valid)
+inline bool to_shm(const Event& e, ShmEvent& out) {
+    std::memset(&out, 0, sizeof(out));
+    out.seq = e.h.seq;
+    out.ts_ns = e.h.ts_ns;
+    out.t_pub_ns = e.h.t_pub_ns;
+    out.topic = static_cast<uint8_t>(e.h.topic);
+    out.kind = static_cast<uint8_t>(e.p.index());
+    bool whole = true;
+    if (const SymbolId sym = symbol_of(e.p); !sym.empty()) {
+        whole = detail::shm_put(out.symbol, ShmEvent::kSymbolCap, sym.name(), out.symbol_len);
+    }
+    std::visit([&](const auto& v) {
+        using T = std::decay_t<decltype(v)>;
+        if constexpr (std::is_same_v<T, Tick>) {
+            out.u.tick.pq = v.pq.raw();
+            out.u.tick.qty = v.qty;
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            whole = detail::shm_put(out.t.text, ShmEvent::kTextCap, v, out.text_len) && whole;
+        } else if constexpr (std::is_same_v<T, Bar>) {
+            out.u.bar.open = v.open.raw();
+            out.u.bar.close = v.close.raw();
+            out.u.bar.high = v.high.raw();
+            out.u.bar.low = v.low.raw();
+            out.u.bar.volume = v.volume;
+            out.t.bar_ts.start_ts_ns = v.start_ts_ns;
+            out.t.bar_ts.end_ts_ns = v.end_ts_ns;
+        } else if constexpr (std::is_same_v<T, Heartbeat>) {
+            out.u.heartbeat.t_ms = v.t_ms;
+        } else if constexpr (std::is_same_v<T, Order>) {
+            out.u.order.order_id = v.order_id;
+            out.u.order.price = v.price.raw();
+            out.u.order.qty = v.qty;
+            out.u.order.side = static_cast<uint8_t>(v.side);
+            out.u.order.type = static_cast<uint8_t>(v.type);
+        } else if constexpr (std::is_same_v<T, Trade>) {
+            out.u.trade.order_id = v.order_id;
+            out.u.trade.trade_id = v.trade_id;
+            out.u.trade.price = v.price.raw();
+            out.u.trade.qty = v.qty;
+            out.u.trade.side = static_cast<uint8_t>(v.side);
+        } else if constexpr (std::is_same_v<T, Reject>) {
+            out.u.reject.order_id = v.order_id;
+            out.u.reject.code = v.code;
+            whole = detail::shm_put(out.t.text, ShmEvent::kTextCap, v.reason, out.text_len) && whole;
+        } else if constexpr (std::is_same_v<T, BookUpdate>) {
+            out.u.book.best_bid = v.best_bid.raw();
+            out.u.book.best_ask = v.best_ask.raw();
+            out.u.book.bid_qty = v.bid_qty;
+            out.u.book.ask_qty = v.ask_qty;
+        } else if constexpr (std::is_same_v<T, RiskAlert>) {
+            out.u.risk.code = v.code;
+            whole = detail::shm_put(out.t.text, ShmEvent::kTextCap, v.reason, out.text_len) && whole;
+        }
+    }, e.p);
+    return whole;
+}
+
+// Reader side name -> SymbolId, so the symbol table (shared lock + hash)
+// is only asked once per new name instead of once per event; a run of
+// events for the same symbol doesn't even hash. One per reading thread.
+class ShmSymbolCache {
+private:
+    std::unordered_map<std::string, SymbolId> ids_;
+    std::string key_;   // reused for lookups: no allocation per event
+    std::string last_name_;
+    SymbolId last_;
+
+public:
+    SymbolId get(std::string_view name) {
+        if (name.empty()) return {};
+        if (name == last_name_) return last_;
+        key_.assign(name);
+        auto it = ids_.find(key_);
+        if (it == ids_.end()) it = ids_.emplace(key_, SymbolId(name)).first;
+        last_name_ = key_;
+        last_ = it->second;
+        return last_;
+    }
+
+    size_t size() const { return ids_.size(); }
+};
+
+namespace detail {
+
+template <typename Resolve>
+inline bool from_shm(const ShmEvent& in, Event& out, Resolve&& resolve) {
+    if (in.topic >= kTopicCount || in.kind > ShmEvent::KRisk) return false;
+    out.h.seq = in.seq;
+    out.h.ts_ns = in.ts_ns;
+    out.h.t_pub_ns = in.t_pub_ns;
+    out.h.topic = static_cast<Topic>(in.topic);
+    auto px = [](int64_t raw) { return Price::from_raw(raw); };
+    const SymbolId sym = resolve(std::string_view(
+        in.symbol, in.symbol_len < ShmEvent::kSymbolCap ? in.symbol_len : ShmEvent::kSymbolCap));
+    auto text = [&in] {
+        return std::string(in.t.text, in.text_len < ShmEvent::kTextCap ? in.text_len : ShmEvent::kTextCap);
+    };
+    switch (in.kind) {
+        case ShmEvent::None: out.p = std::monostate{}; break;
+        case ShmEvent::KTick: out.p = Tick{sym, px(in.u.tick.pq), in.u.tick.qty}; break;
+        case ShmEvent::KText: out.p = text(); break;
+        case ShmEvent::KBar:
+            out.p = Bar{sym, px(in.u.bar.open), px(in.u.bar.close), px(in.u.bar.high), px(in.u.bar.low),
+                        in.u.bar.volume, in.t.bar_ts.start_ts_ns, in.t.bar_ts.end_ts_ns};
+            break;
+        case ShmEvent::KHeartbeat: out.p = Heartbeat{in.u.heartbeat.t_ms}; break;
+        case ShmEvent::KOrder:
+            out.p = Order{in.u.order.order_id, sym, static_cast<Side>(in.u.order.side),
+                          static_cast<OrderType>(in.u.order.type), in.u.order.qty, px(in.u.order.price)};
+            break;
+        case ShmEvent::KTrade:
+            out.p = Trade{in.u.trade.order_id, in.u.trade.trade_id, sym,
+                          static_cast<Side>(in.u.trade.side), in.u.trade.qty, px(in.u.trade.price)};
+            break;
+        case ShmEvent::KReject: out.p = Reject{in.u.reject.order_id, sym, in.u.reject.code, text()}; break;
+        case ShmEvent::KBook:
+            out.p = BookUpdate{sym, px(in.u.book.best_bid), px(in.u.book.best_ask), in.u.book.bid_qty, in.u.book.ask_qty};
+            break;
+        case ShmEvent::KRisk: out.p = RiskAlert{sym, in.u.risk.code, text()}; break;
+    }
+    return true;
+}
+
+}
+
+// false on a record this build doesn't understand
+inline bool from_shm(const ShmEvent& in, Event& out, ShmSymbolCache& symbols) {
+    return detail::from_shm(in, out, [&symbols](std::string_view name) { return symbols.get(name); });
+}
+
+// one-off decode: interns the name every time
+inline bool from_shm(const ShmEvent& in, Event& out) {
+    return detail::from_shm(in, out, [](std::string_view name) { return SymbolId(name); });
+}
+
+}
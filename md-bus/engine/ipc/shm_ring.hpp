@@ -0,0 +1,291 @@
+#pragma once
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../common/log.hpp"
+#include "shm_event.hpp"
+
+namespace md {
+
+// Single-writer, multi-reader broadcast ring in a POSIX shared memory
+// object (/dev/shm/<name>), usable across processes.
+//
+// Every slot carries a sequence word used as a seqlock: the writer marks it
+// odd while copying and even (2 * (pos + 1)) when done. Readers never gate
+// the writer; a dead or slow reader can't stall the feed. Instead a reader
+// that gets lapped notices on its next read (the slot moved past what it
+// expected) and skips ahead, counting the events it lost.
+//
+// Reader processes register in a small table in the header so the writer
+// side can see who is attached and how far behind they are.
+struct ShmRingHeader {
+    static constexpr uint64_t kMagic = 0x6d642d6275732d31ULL; // "md-bus-1"
+    static constexpr uint32_t kVersion = 2;  // 2: prices are fixed-point (Price::raw())
+    static constexpr size_t kMaxReaders = 32;
+
+    struct alignas(64) ReaderSlot {
+        std::atomic<int32_t> pid;        // 0: free
+        std::atomic<uint64_t> cursor;    // next position it will read
+        std::atomic<uint64_t> lost;      // events overwritten before it got to them
+    };
+
+    std::atomic<uint64_t> magic;         // written last by the creator
+    uint32_t version;
+    uint32_t slot_size;
+    uint64_t capacity;                   // power of two
+    alignas(64) std::atomic<uint64_t> write_pos; // events published so far
+    ReaderSlot readers[kMaxReaders];
+};
+
+struct alignas(64) ShmSlot {
+    std::atomic<uint64_t> seq;
+    ShmEvent ev;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared atomics must be lock-free");
+static_assert(std::atomic<int32_t>::is_always_lock_free, "shared atomics must be lock-free");
+static_assert(sizeof(ShmSlot) == 256, "one slot = four cache lines");
+
+// a mapping of the ring; create() for the writer, open() for readers
+class ShmRing {
+private:
+    std::string name_;
+    void* base_{nullptr};
+    size_t bytes_{0};
+    bool owner_{false};
+    ino_t ino_{0}; // owner: the segment we created, in case it got replaced
+
+    static size_t bytes_for(uint64_t capacity) {
+        return sizeof(ShmRingHeader) + capacity * sizeof(ShmSlot);
+    }
+
+    static uint64_t round_up_pow2(uint64_t v) {
+        uint64_t p = 2;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    // the name still refers to the segment we created (not a replacement)
+    bool still_ours() const {
+        const int fd = ::shm_open(("/" + name_).c_str(), O_RDONLY, 0);
+        if (fd < 0) return false;
+        struct stat st{};
+        const bool same = ::fstat(fd, &st) == 0 && st.st_ino == ino_;
+        ::close(fd);
+        return same;
+    }
+
+    bool map(int fd, size_t bytes) {
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) return false;
+        base_ = p;
+        bytes_ = bytes;
+        return true;
+    }
+
+public:
+    ShmRing() = default;
+    ~ShmRing() { close(); }
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    // writer: creates /dev/shm/<name>. Fails if it already exists: another
+    // publisher may own it. replace unlinks it first (e.g. a stale ring
+    // left by a crash); readers still mapping the old one keep it alive
+    // but won't see new events.
+    bool create(const std::string& name, uint64_t capacity, bool replace = false) {
+        close();
+        capacity = round_up_pow2(capacity);
+        const std::string path = "/" + name;
+        if (replace) ::shm_unlink(path.c_str());
+        const int fd = ::shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            if (errno == EEXIST) {
+                log_error("ShmRing: '{}' already exists (another publisher?); pass replace to take it over", path);
+            } else {
+                log_error("ShmRing: shm_open('{}') failed: {}", path, std::strerror(errno));
+            }
+            return false;
+        }
+        const size_t bytes = bytes_for(capacity);
+        struct stat st{};
+        const bool ok = ::ftruncate(fd, static_cast<off_t>(bytes)) == 0 && ::fstat(fd, &st) == 0 && map(fd, bytes);
+        ::close(fd);
+        if (!ok) {
+            log_error("ShmRing: sizing/mapping '{}' ({} bytes) failed: {}", path, bytes, std::strerror(errno));
+            ::shm_unlink(path.c_str());
+            return false;
+        }
+        // fresh pages are zero: every slot seq 0, every reader slot free
+        auto* h = header();
+        h->version = ShmRingHeader::kVersion;
+        h->slot_size = sizeof(ShmSlot);
+        h->capacity = capacity;
+        h->write_pos.store(0, std::memory_order_relaxed);
+        h->magic.store(ShmRingHeader::kMagic, std::memory_order_release);
+        name_ = name;
+        owner_ = true;
+        ino_ = st.st_ino;
+        log_info("ShmRing: created '{}' (capacity = {}, {} KiB)", path, capacity, bytes / 1024);
+        return true;
+    }
+
+    // reader: maps an existing ring; false if missing or incompatible
+    bool open(const std::string& name) {
+        close();
+        const std::string path = "/" + name;
+        const int fd = ::shm_open(path.c_str(), O_RDWR, 0);
+        if (fd < 0) return false;
+        struct stat st{};
+        bool ok = ::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(ShmRingHeader) &&
+                  map(fd, static_cast<size_t>(st.st_size));
+        ::close(fd);
+        if (!ok) return false;
+        const auto* h = header();
+        const uint64_t magic = h->magic.load(std::memory_order_acquire);
+        if (magic == 0) { // creator hasn't finished setting it up
+            close();
+            return false;
+        }
+        if (magic != ShmRingHeader::kMagic ||
+            h->version != ShmRingHeader::kVersion || h->slot_size != sizeof(ShmSlot) ||
+            bytes_for(h->capacity) > bytes_) {
+            log_error("ShmRing: '{}' is not a compatible ring", path);
+            close();
+            return false;
+        }
+        name_ = name;
+        return true;
+    }
+
+    // the creator also removes the name; mappings elsewhere stay valid
+    void close() {
+        if (base_) ::munmap(base_, bytes_);
+        if (owner_ && still_ours()) ::shm_unlink(("/" + name_).c_str());
+        base_ = nullptr;
+        bytes_ = 0;
+        owner_ = false;
+    }
+
+    bool is_open() const { return base_ != nullptr; }
+    const std::string& name() const { return name_; }
+
+    ShmRingHeader* header() const { return static_cast<ShmRingHeader*>(base_); }
+    uint64_t capacity() const { return header()->capacity; }
+    ShmSlot& slot(uint64_t pos) const {
+        auto* slots = reinterpret_cast<ShmSlot*>(static_cast<char*>(base_) + sizeof(ShmRingHeader));
+        return slots[pos & (header()->capacity - 1)];
+    }
+};
+
+// the one writer of a ring
+class ShmWriter {
+private:
+    ShmRing& ring_;
+    uint64_t pos_;        // cached write_pos, we are its only writer
+
+public:
+    explicit ShmWriter(ShmRing& ring)
+        : ring_{ring}, pos_{ring.header()->write_pos.load(std::memory_order_relaxed)} {}
+
+    void write(const ShmEvent& ev) {
+        ShmSlot& s = ring_.slot(pos_);
+        s.seq.store(2 * pos_ + 1, std::memory_order_relaxed);   // odd: being written
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&s.ev, &ev, sizeof(ShmEvent));
+        s.seq.store(2 * (pos_ + 1), std::memory_order_release); // even: readable as pos_
+        ++pos_;
+        ring_.header()->write_pos.store(pos_, std::memory_order_release);
+    }
+
+    // any thread
+    uint64_t published() const { return ring_.header()->write_pos.load(std::memory_order_relaxed); }
+};
+
+// one reader process' cursor; starts at the current end of the ring
+class ShmReader {
+public:
+    enum class Read { Ok, Empty };
+
+private:
+    ShmRing& ring_;
+    ShmRingHeader::ReaderSlot* me_{nullptr};
+    uint64_t pos_;
+    uint64_t lost_{0};
+
+    static bool alive(int32_t pid) {
+        return pid > 0 && (::kill(pid, 0) == 0 || errno != ESRCH);
+    }
+
+public:
+    explicit ShmReader(ShmRing& ring)
+        : ring_{ring}, pos_{ring.header()->write_pos.load(std::memory_order_acquire)} {
+        // take a free reader slot, or one left behind by a dead process
+        const int32_t self = static_cast<int32_t>(::getpid());
+        for (auto& r : ring_.header()->readers) {
+            int32_t cur = r.pid.load(std::memory_order_relaxed);
+            if (cur != 0 && alive(cur)) continue;
+            if (r.pid.compare_exchange_strong(cur, self, std::memory_order_acq_rel)) {
+                me_ = &r;
+                me_->cursor.store(pos_, std::memory_order_relaxed);
+                me_->lost.store(0, std::memory_order_relaxed);
+                break;
+            }
+        }
+        if (!me_) log_warn("ShmReader: all {} reader slots of '{}' taken, reading unregistered",
+                           ShmRingHeader::kMaxReaders, ring_.name());
+    }
+
+    ~ShmReader() {
+        if (me_) me_->pid.store(0, std::memory_order_release);
+    }
+
+    ShmReader(const ShmReader&) = delete;
+    ShmReader& operator=(const ShmReader&) = delete;
+
+    // copies the next event into out; skips ahead (counting lost()) if the
+    // writer lapped us
+    Read read(ShmEvent& out) {
+        for (;;) {
+            ShmSlot& s = ring_.slot(pos_);
+            const uint64_t want = 2 * (pos_ + 1);
+            const uint64_t before = s.seq.load(std::memory_order_acquire);
+            if (before < want) return Read::Empty;            // not written yet (or mid-write of pos_)
+            if (before == want) {
+                std::memcpy(&out, &s.ev, sizeof(ShmEvent));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s.seq.load(std::memory_order_relaxed) == want) {
+                    ++pos_;
+                    if (me_) me_->cursor.store(pos_, std::memory_order_relaxed);
+                    return Read::Ok;
+                }
+            }
+            // overwritten under us: jump to the oldest event still in the ring
+            const uint64_t end = ring_.header()->write_pos.load(std::memory_order_acquire);
+            const uint64_t oldest = end > ring_.capacity() ? end - ring_.capacity() + 1 : 0;
+            if (oldest > pos_) {
+                lost_ += oldest - pos_;
+                if (me_) me_->lost.store(lost_, std::memory_order_relaxed);
+                pos_ = oldest;
+            }
+        }
+    }
+
+    bool readable() const {
+        return ring_.slot(pos_).seq.load(std::memory_order_acquire) >= 2 * (pos_ + 1);
+    }
+
+    uint64_t position() const { return pos_; }
+    uint64_t lost() const { return lost_; }
+};
+
+}
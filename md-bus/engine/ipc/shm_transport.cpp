@@ -0,0 +1,120 @@
+#include "shm_transport.hpp"
+
+#include <array>
+
+#include "../common/log.hpp"
+
+namespace md {
+
+SharedMemoryPublisher::SharedMemoryPublisher(EventBus& bus, const std::string& ring_name,
+                                             const ShmPublisherOptions& opts)
+    : bus_{bus} {
+    if(!ring_.create(ring_name, opts.capacity, opts.replace)) return;
+    writer_ = std::make_unique<ShmWriter>(ring_);
+
+    SubOptions so{.overflow = opts.overflow, .name = opts.name};
+    if(!opts.topics.empty()){
+        std::array<bool, kTopicCount> want{};
+        for(Topic t : opts.topics){
+            if(static_cast<size_t>(t) < kTopicCount) want[static_cast<size_t>(t)] = true;
+        }
+        so.filter.where = [want](const Event& e){ return want[static_cast<size_t>(e.h.topic)]; };
+    }
+    // one subscription = one consumer thread, so the ring keeps a single writer
+    sub_ = bus_.subscribe_all([this](const Event& e){
+        ShmEvent rec;
+        if(!to_shm(e, rec)) truncated_.fetch_add(1, std::memory_order_relaxed);
+        writer_->write(rec);
+    }, so);
+    log_info("SharedMemoryPublisher: bus -> '{}'", ring_name);
+}
+
+SharedMemoryPublisher::~SharedMemoryPublisher(){
+    if(sub_) bus_.unsubscribe(sub_);
+}
+
+size_t SharedMemoryPublisher::readers() const {
+    if(!ring_.is_open()) return 0;
+    size_t n = 0;
+    for(const auto& r : ring_.header()->readers){
+        if(r.pid.load(std::memory_order_acquire) != 0) ++n;
+    }
+    return n;
+}
+
+void SharedMemoryPublisher::collect_metrics(MetricSet& out) const {
+    const MetricLabels l{{"ring", ring_.name()}};
+    out.counter("md_shm_published_total", (double)published(), l);
+    out.counter("md_shm_truncated_total", (double)truncated(), l);
+    if(!ring_.is_open()) return;
+    for(const auto& r : ring_.header()->readers){
+        const int32_t pid = r.pid.load(std::memory_order_relaxed);
+        if(pid == 0) continue;
+        const uint64_t cur = r.cursor.load(std::memory_order_relaxed);
+        MetricLabels rl = l;
+        rl.emplace_back("pid", std::to_string(pid));
+        out.gauge("md_shm_reader_lag", (double)(published() > cur ? published() - cur : 0), rl);
+        out.counter("md_shm_reader_lost_total", (double)r.lost.load(std::memory_order_relaxed), rl);
+    }
+}
+
+SharedMemorySubscriber::SharedMemorySubscriber(EventBus& bus, const std::string& ring_name,
+                                               const ShmSubscriberOptions& opts)
+    : bus_{bus}, ring_name_{ring_name}, opts_{opts} {
+    th_ = std::thread([this]{ loop(); });
+}
+
+SharedMemorySubscriber::~SharedMemorySubscriber(){ stop(); }
+
+void SharedMemorySubscriber::stop(){
+    run_.store(false, std::memory_order_relaxed);
+    if(th_.joinable()) th_.join();
+}
+
+void SharedMemorySubscriber::loop(){
+    apply_thread_config(opts_.thread);
+
+    ShmRing ring;
+    while(!ring.open(ring_name_)){
+        if(!run_.load(std::memory_order_relaxed)) return;
+        std::this_thread::sleep_for(opts_.open_retry);
+    }
+    ShmReader reader(ring);
+    attached_.store(true, std::memory_order_release);
+    log_info("SharedMemorySubscriber: '{}' -> bus", ring_name_);
+
+    ShmEvent rec;
+    Event ev;
+    ShmSymbolCache symbols; // intern each name once, not once per event
+    uint32_t idle = 0;
+    while(run_.load(std::memory_order_relaxed)){
+        if(reader.read(rec) == ShmReader::Read::Empty){
+            // the writer can't ring us, so idle by polling
+            ++idle;
+            if(opts_.wait == WaitStrategy::BusySpin || idle < 128) cpu_relax();
+            else if(opts_.wait == WaitStrategy::SpinYield || idle < 128 + 16) std::this_thread::yield();
+            else std::this_thread::sleep_for(std::chrono::microseconds(50));
+            continue;
+        }
+        idle = 0;
+        if(!from_shm(rec, ev, symbols)){
+            bad_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        // keeps the publisher's ts_ns/t_pub_ns, so bus latency is end to end
+        bus_.publish_preserve(std::move(ev));
+        received_.fetch_add(1, std::memory_order_relaxed);
+        lost_.store(reader.lost(), std::memory_order_relaxed);
+    }
+    lost_.store(reader.lost(), std::memory_order_relaxed);
+}
+
+void SharedMemorySubscriber::collect_metrics(MetricSet& out) const {
+    const MetricLabels l{{"ring", ring_name_}};
+    out.counter("md_shm_received_total", (double)received(), l);
+    out.counter("md_shm_lost_total", (double)lost(), l);
+    out.counter("md_shm_bad_total", (double)bad_.load(std::memory_order_relaxed), l);
+    out.gauge("md_shm_attached", attached() ? 1.0 : 0.0, l);
+}
+
+}
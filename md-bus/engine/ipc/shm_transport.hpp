@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../bus/bus.hpp"
+#include "../common/thread_util.hpp"
+#include "../common/wait.hpp"
+#include "shm_ring.hpp"
+
+namespace md {
+
+// Bridges a local EventBus to other processes through a ShmRing:
+//
+//   feed process:      bus --SharedMemoryPublisher--> /dev/shm/md-feed
+//   strategy process:  /dev/shm/md-feed --SharedMemorySubscriber--> bus
+//
+// One publisher per ring (it is the ring's single writer); any number of
+// subscriber processes, each with its own cursor. Slow subscribers lose
+// events instead of holding the publisher back (see ShmReader).
+
+struct ShmPublisherOptions {
+    uint64_t capacity = 65536;           // slots, rounded up to a power of two
+    std::vector<Topic> topics;           // empty: every topic
+    std::string name = "shm_pub";        // name of the bus subscription
+    OverflowPolicy overflow = OverflowPolicy::Block;
+    // take over an existing ring of that name instead of failing; its
+    // readers are orphaned (use for a stale ring after a crash)
+    bool replace = false;
+};
+
+class SharedMemoryPublisher {
+private:
+    EventBus& bus_;
+    ShmRing ring_;
+    std::unique_ptr<ShmWriter> writer_;
+    SubId sub_{0};
+    std::atomic<uint64_t> truncated_{0};
+
+public:
+    SharedMemoryPublisher(EventBus& bus, const std::string& ring_name,
+                          const ShmPublisherOptions& opts = {});
+    ~SharedMemoryPublisher();
+
+    SharedMemoryPublisher(const SharedMemoryPublisher&) = delete;
+    SharedMemoryPublisher& operator=(const SharedMemoryPublisher&) = delete;
+
+    bool ok() const { return sub_ != 0; }
+    uint64_t published() const { return writer_ ? writer_->published() : 0; }
+    uint64_t truncated() const { return truncated_.load(std::memory_order_relaxed); }
+    size_t readers() const; // reader processes attached right now
+    void collect_metrics(MetricSet& out) const;
+};
+
+struct ShmSubscriberOptions {
+    // how the reader thread idles; there is no cross-process doorbell, so
+    // SpinPark means spin, yield, then short sleeps
+    WaitStrategy wait = WaitStrategy::SpinYield;
+    ThreadConfig thread{.name = "md-shm-sub"};
+    // keep retrying to open the ring until it shows up (or stop())
+    std::chrono::milliseconds open_retry{10};
+};
+
+class SharedMemorySubscriber {
+private:
+    EventBus& bus_;
+    std::string ring_name_;
+    ShmSubscriberOptions opts_;
+    std::atomic<bool> run_{true};
+    std::atomic<bool> attached_{false};
+    std::atomic<uint64_t> received_{0};
+    std::atomic<uint64_t> lost_{0};
+    std::atomic<uint64_t> bad_{0};
+    std::thread th_;
+
+    void loop();
+
+public:
+    SharedMemorySubscriber(EventBus& bus, const std::string& ring_name,
+                           const ShmSubscriberOptions& opts = {});
+    ~SharedMemorySubscriber();
+
+    SharedMemorySubscriber(const SharedMemorySubscriber&) = delete;
+    SharedMemorySubscriber& operator=(const SharedMemorySubscriber&) = delete;
+
+    void stop();
+
+    // reader registered on the ring; events published from now on arrive
+    bool attached() const { return attached_.load(std::memory_order_acquire); }
+    uint64_t received() const { return received_.load(std::memory_order_relaxed); }
+    uint64_t lost() const { return lost_.load(std::memory_order_relaxed); }
+    void collect_metrics(MetricSet& out) const;
+};
+
+}
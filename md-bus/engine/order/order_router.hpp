@@ -3,7 +3,7 @@
 #include <mutex>
 #include <optional>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 #include "../bus/bus.hpp"
 #include "../common/event.hpp"
@@ -28,85 +28,85 @@ private :
     SubId sub_order_{0};
 
     mutable std::mutex px_mu;
-    std::unordered_map<std::string, double> last_px_;
+    std::vector<std::optional<Price>> last_px_; // indexed by SymbolId
 
     std::atomic<uint64_t> next_trade_id_{1};
 
     //methods-->
-    void on_tick(const Event& ev) {
-        const Tick* t = std::get_if<Tick>(&ev.p);
-        if(!t) return;
-
+    void on_tick(const Tick& t) {
         {
             std::scoped_lock lk(px_mu);
-            last_px_[t->symbol] = t->pq;
+            if(t.symbol.id() >= last_px_.size()) last_px_.resize(t.symbol.id() + 1);
+            last_px_[t.symbol.id()] = t.pq;
         }
         if(trace_) {
-            log_debug("[OrderRouter] tick sym={} px={}", t->symbol, t->pq);
+            log_debug("[OrderRouter] tick sym={} px={}", t.symbol, t.pq);
         }
     }
     //optional means that this function will return double or nothing
-    std::optional<double> last_price(const std::string& sym) const {
-        auto it = last_px_.find(sym);
+    std::optional<Price> last_price(SymbolId sym) const {
+        std::scoped_lock lk(px_mu);
         //nullopt is no value marker for optional
-        if(it == last_px_.end())return std::nullopt;
-        return it->second;
+        if(sym.id() >= last_px_.size()) return std::nullopt;
+        return last_px_[sym.id()];
     }
 
-    void on_order(const Event& ev) {
-        const Order* o = std::get_if<Order>(&ev.p);
-        if(!o) return;
-
+    void on_order(const Order& o) {
         if(!trace_) {
             log_debug("[OrderRouter] ORDER id={} sym={} side={} type={} qty={} px={}",
-                      o->order_id, o->symbol,
-                      (o->side == Side::Buy ? "BUY" : "SELL"),
-                      (o->type == OrderType::Market ? "MKT" : "LMT"),
-                      o->qty, o->price);
+                      o.order_id, o.symbol,
+                      (o.side == Side::Buy ? "BUY" : "SELL"),
+                      (o.type == OrderType::Market ? "MKT" : "LMT"),
+                      o.qty, o.price);
         }
 
-        if(o->order_id == 0){
-            publish_reject(*o, 1001, "order_id=0");
+        if(o.order_id == 0){
+            publish_reject(o, 1001, "order_id=0");
+            return;
+        }
+        if(o.symbol.empty()) {
+            publish_reject(o, 1002, "empty symbol");
             return;
         }
-        if(o->symbol.empty()) {
-            publish_reject(*o, 1002, "empty symbol");
+        if(o.qty <= 0) {
+            publish_reject(o, 1003, "qty<=0");
             return;
         }
-        if(o->qty <= 0) {
-            publish_reject(*o, 1003, "qty<=0");
+        if(o.type == OrderType::Limit && o.price <= Price{}) {
+            publish_reject(o, 1004, "limit price<=0");
             return;
         }
-        if(o->type == OrderType::Limit && o->price <= 0.0) {
-            publish_reject(*o, 1004, "limit price<=0");
+        if(o.type == OrderType::Limit && !o.price.on_grid(price_decimals(o.symbol))) {
+            publish_reject(o, 1005, "limit price off the symbol's tick grid");
             return;
         }
 
-        auto px_opt = last_price(o->symbol);
+        auto px_opt = last_price(o.symbol);
         if(!px_opt.has_value()) {
-            publish_reject(*o, 2001, "no last price (need MD_TICK first)");
+            publish_reject(o, 2001, "no last price (need MD_TICK first)");
             return;
         }
-        const double mkt_px = *px_opt;
+        const Price mkt_px = *px_opt;
 
-        double fill_px = 0.0;
+        Price fill_px;
 
-        if(o->type == OrderType::Market) {
+        if(o.type == OrderType::Market) {
             fill_px = mkt_px;
         } else {
-            const bool marketable = (o->side == Side::Buy) ?
-            (mkt_px <= o->price) : (mkt_px >= o->price);
+            // integer compares: a limit at the last price always fills
+            const bool marketable = (o.side == Side::Buy) ?
+            (mkt_px <= o.price) : (mkt_px >= o.price);
 
             if(!marketable) {
-                publish_reject(*o, 2002, "limit not marketable vs last price");
+                publish_reject(o, 2002, "limit not marketable vs last price");
                 return;
             }
             fill_px = mkt_px;
         }
-        publish_trade(*o, fill_px);
+        publish_trade(o, fill_px);
     }
 
-    void publish_trade(const Order& o, double fill_px) {
+    void publish_trade(const Order& o, Price fill_px) {
         Trade tr;
         tr.order_id = o.order_id;
         tr.trade_id = next_trade_id_.fetch_add(1, std::memory_order_relaxed);
@@ -115,7 +115,7 @@ private :
         tr.qty = o.qty;
         tr.price = fill_px;
         
-        bus_.publish(make_event(Topic::TRADE, tr));
+        bus_.publish<Topic::TRADE>(tr);
 
 
         if (trace_) {
@@ -131,7 +131,7 @@ private :
         r.code = code;
         r.reason = std::move(reason);
 
-        bus_.publish(make_event(Topic::REJECT, r));
+        bus_.publish<Topic::REJECT>(r);
 
         if (trace_) {
             log_debug("[OrderRouter] REJECT oid={} sym={} code={} reason={}",
@@ -142,9 +142,12 @@ private :
 public :
     explicit OrderRouter(EventBus& bus, bool trace = false)
         :bus_{bus}, trace_{trace} {
-            sub_tick_ = bus_.subscribe(Topic::MD_TICK, [this](const Event& ev){on_tick(ev);});
+            // only the last price per symbol matters here: after a burst,
+            // skip straight to the freshest tick instead of replaying them all
+            sub_tick_ = bus_.subscribe<Topic::MD_TICK>([this](const Tick& t){on_tick(t);},
+                                       SubOptions{.name = "router_ticks", .conflate_by_symbol = true});
 
-            sub_order_ = bus_.subscribe(Topic::ORDER, [this](const Event& ev){on_order(ev);});
+            sub_order_ = bus_.subscribe<Topic::ORDER>([this](const Order& o){on_order(o);});
 
                 log_info("OrderRouter started (trace={})", trace_ ? 1 : 0);
         }
@@ -25,6 +25,8 @@ void EventRecorder::on_event(const Event& e){
     if(!out_)return;
     const std::string line = serialize_event(e);
     out_ << line << '\n';
+    events_written_.fetch_add(1, std::memory_order_relaxed);
+    bytes_written_.fetch_add(line.size() + 1, std::memory_order_relaxed);
 }
 
 void EventRecorder::flush() {
@@ -34,6 +36,12 @@ void EventRecorder::flush() {
     }
 }
 
+void EventRecorder::collect_metrics(MetricSet& out) const {
+    const MetricLabels l{{"path", path_}};
+    out.counter("md_recorder_events_total", (double)events_written(), l);
+    out.counter("md_recorder_bytes_total", (double)bytes_written(), l);
+}
+
 void EventRecorder::close() {
     std::lock_guard<std::mutex> lk(mu_);
     if(out_) {
@@ -1,5 +1,7 @@
 #pragma once 
 
+#include <atomic>
+#include <filesystem>
 #include <fstream>
 #include <mutex>
 #include <string>
@@ -7,6 +9,7 @@
 #include "../common/event.hpp"
 #include "../common/event_io.hpp"
 #include "../common/log.hpp"
+#include "../common/metrics_export.hpp"
 
 namespace md{
 
@@ -16,6 +19,10 @@ private:
     std::ofstream out_;
     bool opened_{false};
     std::string path_;
+
+    // read by collect_metrics() from any thread
+    std::atomic<uint64_t> events_written_{0};
+    std::atomic<uint64_t> bytes_written_{0};
 public:
     explicit EventRecorder(const std::string& path);
     ~EventRecorder();
@@ -28,6 +35,10 @@ public:
     void flush();
     void close();
 
+    uint64_t events_written() const { return events_written_.load(std::memory_order_relaxed); }
+    uint64_t bytes_written() const { return bytes_written_.load(std::memory_order_relaxed); }
+    void collect_metrics(MetricSet& out) const;
+
 };
 
 
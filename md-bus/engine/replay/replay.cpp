@@ -5,6 +5,7 @@
 #include <thread>
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace md {
 
@@ -21,7 +22,7 @@ bool EventReplay::match_filter(const Event& e) const {
             return false;
         }
         const auto& t = std::get<Tick> (e.p);
-        if(t.symbol != filter_.symbol) {
+        if(t.symbol != filter_.symbol) { // ids: an integer compare
             return false;
         }
     }
@@ -36,7 +37,8 @@ bool EventReplay::match_filter(const Event& e) const {
 
 
 template <typename Fn>
-static void for_each_event_in_file(const std::string& path, Fn&& fn){
+static void for_each_event_in_file(const std::string& path, std::atomic<uint64_t>& read,
+                                   std::atomic<uint64_t>& parse_errors, Fn&& fn){
     std::ifstream in(path);
     if(!in){
         log_error("EventReplay: failed to open replay file '{}'", path);
@@ -48,13 +50,11 @@ static void for_each_event_in_file(const std::string& path, Fn&& fn){
         if(line.empty())continue;
         Event e;
         if(!parse_event(line, e)) {
+            parse_errors.fetch_add(1, std::memory_order_relaxed);
             log_warn("EventReplay: failed to parse line: {}", line);
             continue;
         }
-        if(e.h.ts_ns == 0) {
-            log_info("EventReplay: skipping internal event");
-            continue;
-        }
+        read.fetch_add(1, std::memory_order_relaxed);
         if(!fn(e)){
             break;
         }
@@ -64,8 +64,18 @@ static void for_each_event_in_file(const std::string& path, Fn&& fn){
 void EventReplay::replay_fast(EventBus& bus){
     log_info("EventReplay: starting fast replay from '{}'", path_);
     events_published_ = 0;
-
-    for_each_event_in_file(path_, [this, &bus](Event& e) {
+    running_.store(true, std::memory_order_relaxed);
+
+    // no pacing, so hand events to the bus in batches: one seq reservation
+    // and one ingress claim per batch instead of per event
+    std::vector<Event> batch;
+    batch.reserve(kFastBatch);
+    auto flush = [&bus, &batch] {
+        bus.publish_batch_preserve(batch.data(), batch.size());
+        batch.clear();
+    };
+
+    for_each_event_in_file(path_, events_read_, parse_errors_, [&](Event& e) {
         if(!match_filter(e)) {
             return true; // want the function to coninue;
         }
@@ -80,12 +90,18 @@ void EventReplay::replay_fast(EventBus& bus){
             md::log_info("[STEP] Press Enter to play next event...\n");
             std::string dummy;
             std::getline(std::cin, dummy);
+            bus.publish_preserve(e);
+            ++events_published_;
+            return true;
         }
 
-        bus.publish_preserve(e);
+        batch.push_back(std::move(e));
         ++events_published_;
+        if(batch.size() == kFastBatch) flush();
         return true;
     });
+    flush();
+    running_.store(false, std::memory_order_relaxed);
 
     log_info("EventReplay: fast replay finished");
 }
@@ -111,6 +127,7 @@ void EventReplay::replay_speed(EventBus& bus, double speed){
     std::string line;
     bool first = true;
     events_published_  = 0;
+    running_.store(true, std::memory_order_relaxed);
     uint64_t first_ts = 0;
     uint64_t prev_ts = 0;
     auto wall_start = std::chrono::steady_clock::now();
@@ -119,16 +136,11 @@ void EventReplay::replay_speed(EventBus& bus, double speed){
         if(line.empty())continue;
         Event e;
         if(!parse_event(line, e)) {
+            parse_errors_.fetch_add(1, std::memory_order_relaxed);
             log_warn("EventReplay: failed to parse line: {}", line);
             continue;
         }
-
-        if(e.h.ts_ns == 0) {
-            log_info("Replay: skipping internal stop event (seq={}, topic={})",
-                     e.h.seq,
-                     static_cast<int>(e.h.topic));
-            continue;
-        }
+        events_read_.fetch_add(1, std::memory_order_relaxed);
 
         if(!match_filter(e)) {
             continue;
@@ -179,7 +191,16 @@ void EventReplay::replay_speed(EventBus& bus, double speed){
         bus.publish_preserve(e);
         ++events_published_;
     }
+    running_.store(false, std::memory_order_relaxed);
     log_info("EventReplay: timed replay finished");
 }
 
+void EventReplay::collect_metrics(MetricSet& out) const {
+    const MetricLabels l{{"path", path_}};
+    out.counter("md_replay_events_read_total", (double)events_read(), l);
+    out.counter("md_replay_events_published_total", (double)events_published(), l);
+    out.counter("md_replay_parse_errors_total", (double)parse_errors_.load(std::memory_order_relaxed), l);
+    out.gauge("md_replay_running", running_.load(std::memory_order_relaxed) ? 1.0 : 0.0, l);
+}
+
 }
\ No newline at end of file
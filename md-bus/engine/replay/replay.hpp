@@ -1,9 +1,11 @@
 #pragma once 
+#include <atomic>
 #include <string>
 
 #include "../common/event.hpp"
 #include "../common/event_io.hpp"
 #include "../common/log.hpp"
+#include "../common/metrics_export.hpp"
 #include "../bus/bus.hpp"
 
 
@@ -14,7 +16,7 @@ struct ReplayFilter {
     Topic topic{};
 
     bool filter_by_symbol{false};
-    std::string symbol;
+    SymbolId symbol;
 
     bool filter_by_time{false};
     uint64_t ts_min{0};
@@ -29,7 +31,13 @@ private :
     std::string path_;
     ReplayFilter filter_{};
     bool step_mode_{false};
-    size_t events_published_{0};
+    // read by collect_metrics() from any thread while a replay runs
+    std::atomic<size_t> events_published_{0};
+    std::atomic<uint64_t> events_read_{0};   // parsed from the file, before filtering
+    std::atomic<uint64_t> parse_errors_{0};
+    std::atomic<bool> running_{false};
+
+    static constexpr size_t kFastBatch = 256;
     
     //Returns true if event passes all active filters
     bool match_filter(const Event& e) const;
@@ -54,6 +62,10 @@ public :
     }
 
     void enable_step_mode(bool on = true) {step_mode_ = on ;} 
+
+    size_t events_published() const { return events_published_.load(std::memory_order_relaxed); }
+    uint64_t events_read() const { return events_read_.load(std::memory_order_relaxed); }
+    void collect_metrics(MetricSet& out) const;
 };
 
 }
\ No newline at end of file
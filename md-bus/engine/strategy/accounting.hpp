@@ -6,9 +6,10 @@
 #include <cstdint>
 #include <fstream>
 #include <algorithm>
-#include <limits>
 
 #include "../common/log.hpp"
+#include "../common/price.hpp"
+#include "../common/symbol.hpp"
 
 namespace md {
 
@@ -46,13 +47,13 @@ inline const char* to_string(ExitReason r){
 
 //keeping track
 struct AccountTrade {
-    std::string symbol;
+    SymbolId symbol;
     PosSide side = PosSide::Long;
     int qty = 0;
 
-    double entry_price = 0.0;
-    double exit_price = 0.0;
-    double pnl = 0.0;
+    Price entry_price;
+    Price exit_price;
+    Price pnl;
 
     uint64_t entry_ts_ns = 0;
     uint64_t exit_ts_ns = 0;
@@ -61,37 +62,36 @@ struct AccountTrade {
 };
 
 struct Position {
-    std::string symbol;
+    SymbolId symbol;
     bool open = false;
     PosSide side = PosSide::Long;
     int qty = 0;
-    double entry_pq = 0.0;
+    Price entry_pq;
     uint64_t entry_ts_ns = 0;
 };
 
 class Account {
 private : 
-    double starting_cash_{0.0};
-    double realized_pnl_{0.0};
-    double equity_{0.0};
-    double peak_equity_{0.0};
-    double max_drawdown_{0.0};
+    // all money is fixed-point: PnL adds up exactly, trade after trade
+    Price starting_cash_;
+    Price realized_pnl_;
+    Price equity_;
+    Price peak_equity_;
+    Price max_drawdown_;
 
     Position pos_{};
     std::vector<AccountTrade> trades_;
 public :
-    explicit Account(double starting_cash = 0.0)
+    explicit Account(Price starting_cash = Price{})
         :starting_cash_{starting_cash},
-        realized_pnl_(0.0),
         equity_(starting_cash),
-        peak_equity_(starting_cash),
-        max_drawdown_(0.0) {}
+        peak_equity_(starting_cash) {}
 
     bool has_open_position() const {return pos_.open;}
     const Position& position() const {return pos_;}
 
-    void open_long(const std::string& symbol,
-                    int qty, double pq, uint64_t ts_ns) {
+    void open_long(SymbolId symbol,
+                    int qty, Price pq, uint64_t ts_ns) {
         if(pos_.open) {
             log_warn("Account::open_long: position already open, ignoring");
             return;
@@ -106,14 +106,14 @@ public :
         log_info("Account: open LONG {} qty={} pq={}", symbol, qty, pq);
     }
 
-    void close_position(double pq, uint64_t ts_ns, ExitReason reason){
+    void close_position(Price pq, uint64_t ts_ns, ExitReason reason){
         if(!pos_.open){
             log_warn("Account::close_position: no open position, ignoring");
             return;
         }
 
-        double signed_qty = static_cast<double>(pos_.qty) * (pos_.side == PosSide::Long ? 1.0 : -1.0);
-        double trade_pnl = signed_qty * (pq - pos_.entry_pq);
+        const int64_t signed_qty = pos_.side == PosSide::Long ? pos_.qty : -pos_.qty;
+        const Price trade_pnl = (pq - pos_.entry_pq) * signed_qty;
 
         AccountTrade tr;
         tr.symbol      = pos_.symbol;
@@ -140,34 +140,33 @@ public :
         
         pos_.open        = false;
         pos_.qty         = 0;
-        pos_.entry_pq    = 0.0;
+        pos_.entry_pq    = Price{};
         pos_.entry_ts_ns = 0;
     }
-    double realized_pnl() const {return realized_pnl_;}
+    Price realized_pnl() const {return realized_pnl_;}
 
     // Unrealized PnL at given price
-    double unrealized_pnl(double last_pq) const {
-        if (!pos_.open) return 0.0;
-        double signed_qty = static_cast<double>(pos_.qty) *
-                            (pos_.side == PosSide::Long ? 1.0 : -1.0);
+    Price unrealized_pnl(Price last_pq) const {
+        if (!pos_.open) return Price{};
+        const int64_t signed_qty = pos_.side == PosSide::Long ? pos_.qty : -pos_.qty;
         return (last_pq - pos_.entry_pq) * signed_qty;
     }
 
-    void update_equity(double last_pq) {
-        double u = unrealized_pnl(last_pq);
+    void update_equity(Price last_pq) {
+        const Price u = unrealized_pnl(last_pq);
         equity_ = starting_cash_ + realized_pnl_ + u;
         if(equity_ > peak_equity_) {
             peak_equity_ = equity_;
         }else {
-            double dd = peak_equity_ - equity_;
+            const Price dd = peak_equity_ - equity_;
             if(dd > max_drawdown_) {
                 max_drawdown_ = dd;
             }
         }
     }
     
-    double equity() const {return equity_;}
-    double max_drawdown() const {return max_drawdown_;}
+    Price equity() const {return equity_;}
+    Price max_drawdown() const {return max_drawdown_;}
 
     const std::vector<AccountTrade>& trades() const { return trades_; }
 
@@ -182,16 +181,16 @@ public :
         if (!trades_.empty()) {
             int wins = 0;
             int losses = 0;
-            double sum_win = 0.0;
-            double sum_loss = 0.0;
-            double best = std::numeric_limits<double>::lowest();
-            double worst = std::numeric_limits<double>::max();
+            Price sum_win;
+            Price sum_loss;
+            Price best = Price::min();
+            Price worst = Price::max();
 
             for (const auto& tr : trades_) {
-                if (tr.pnl > 0) {
+                if (tr.pnl > Price{}) {
                     wins++;
                     sum_win += tr.pnl;
-                } else if (tr.pnl < 0) {
+                } else if (tr.pnl < Price{}) {
                     losses++;
                     sum_loss += tr.pnl;
                 }
@@ -201,15 +200,15 @@ public :
 
             int n = static_cast<int>(trades_.size());
             double win_rate = (n > 0) ? (static_cast<double>(wins) / n * 100.0) : 0.0;
-            double avg_win  = (wins > 0) ? (sum_win / wins) : 0.0;
-            double avg_loss = (losses > 0) ? (sum_loss / losses) : 0.0;
+            double avg_win  = (wins > 0) ? (sum_win.to_double() / wins) : 0.0;
+            double avg_loss = (losses > 0) ? (sum_loss.to_double() / losses) : 0.0;
 
             md::log_info("  wins             = {} ({:.2f}%)\n", wins, win_rate);
             md::log_info("  losses           = {}\n", losses);
             md::log_info("  avg_win          = {}\n", avg_win);
             md::log_info("  avg_loss         = {}\n", avg_loss);
-            md::log_info("  best_trade       = {}\n", (trades_.empty() ? 0.0 : best));
-            md::log_info("  worst_trade      = {}\n", (trades_.empty() ? 0.0 : worst));
+            md::log_info("  best_trade       = {}\n", best);
+            md::log_info("  worst_trade      = {}\n", worst);
         }
 
         md::log_info("=========================\n");
@@ -223,14 +222,14 @@ public :
         }
         out << "symbol,side,qty,entry_price,exit_price,entry_ts_ns,exit_ts_ns,pnl,exit_reason\n";
         for (const auto& tr : trades_) {
-            out << tr.symbol << ","
+            out << tr.symbol.name() << ","
                 << to_string(tr.side) << ","
                 << tr.qty << ","
-                << tr.entry_price << ","
-                << tr.exit_price << ","
+                << format_price(tr.entry_price) << ","
+                << format_price(tr.exit_price) << ","
                 << tr.entry_ts_ns << ","
                 << tr.exit_ts_ns << ","
-                << tr.pnl << ","
+                << format_price(tr.pnl) << ","
                 << to_string(tr.exit_reason) << "\n";
         }
 
@@ -26,24 +26,26 @@ namespace md {
 class BarMomentumStrategy : public IStrategy {
 private : 
     Account& account_;
-    std::string symbol_;
+    SymbolId symbol_;
     BarWindow window_;
-    double mom_threshold_;
+    Price mom_threshold_;
     int qty_;
-    double   last_close_ = 0.0;
+    Price    last_close_;
     uint64_t last_ts_    = 0;
 public :
     BarMomentumStrategy(Account& account,
-                    std::string symbol, 
+                    SymbolId symbol,
                     std::size_t window_size,
-                    double momentum_threshold,
+                    Price momentum_threshold,
                     int qty)
         :account_{account},
-        symbol_{std::move(symbol)},
+        symbol_{symbol},
         window_{window_size},
         mom_threshold_{momentum_threshold},
         qty_{qty} {}
     
+    std::vector<SymbolId> symbols() const override { return {symbol_}; }
+
     void on_tick(const Tick& ,const Event&) override{};
     //ignore the tick level data in this strategy
 
@@ -61,23 +63,23 @@ public :
         last_ts_    = e.h.ts_ns;
         window_.push(b);
         if(!window_.full()) return ;
-        double mom = window_.momentum();
-        log_debug("[BARMOM] bar sym={} o={} h={} l={} c={} v={} mom={:.4f} seq={}",
+        const Price mom = window_.momentum();
+        log_debug("[BARMOM] bar sym={} o={} h={} l={} c={} v={} mom={} seq={}",
                   b.symbol, b.open, b.high, b.low, b.close, b.volume, mom, e.h.seq);
         if(!account_.has_open_position()) {
 
             //entry logic : momentum strongly positive
             if(mom > mom_threshold_) {
                 account_.open_long(symbol_, qty_, b.close, e.h.ts_ns);
-                log_info("[BARMOM] ENTER LONG sym={} c={} mom={:.4f} thr={:.4f} qty={}",
+                log_info("[BARMOM] ENTER LONG sym={} c={} mom={} thr={} qty={}",
                          symbol_, b.close, mom, mom_threshold_, qty_);
             }
             return ;
         }
 
-        if(mom <= 0.0) {
+        if(mom <= Price{}) {
             const Position& pos = account_.position();
-            log_info("[BARMOM] EXIT LONG sym={} c={} mom={:.4f} (<=0) qty={}",
+            log_info("[BARMOM] EXIT LONG sym={} c={} mom={} (<=0) qty={}",
                      pos.symbol, b.close, mom, pos.qty);
             account_.close_position(b.close, e.h.ts_ns, ExitReason::Threshold);
         }
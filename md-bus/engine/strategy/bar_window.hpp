@@ -29,8 +29,8 @@ public :
         return window_.size();
     }
 
-    double momentum() const {
-        if(!full()) return 0.0;
+    Price momentum() const {
+        if(!full()) return Price{};
         const auto& first = window_.front();
         const auto& last = window_.back();
         return last.close - first.close;
@@ -50,24 +50,15 @@ public :
     {
         //Tick
         if(mode_ != StrategyMode::BarOnly){
-            sub_ticks_ = bus.subscribe(Topic::MD_TICK, [this](const Event& e){
-                if(std::holds_alternative<Tick>(e.p)){
-                    const auto& t = std::get<Tick>(e.p);
-                    strat_.on_tick(t, e);
-                }else {
-                    log_warn("StrategyRunner: MD_TICK event without Tick payload (seq={})",
-                                 e.h.seq);
-                }
+            sub_ticks_ = bus.subscribe<Topic::MD_TICK>([this](const Tick& t, const Event& e){
+                strat_.on_tick(t, e);
             });
         }
 
         //LOG
-        sub_logs_ = bus_.subscribe(Topic::LOG,
-            [this](const Event& e) {
-                if (std::holds_alternative<std::string>(e.p)) {
-                    const auto& msg = std::get<std::string>(e.p);
-                    strat_.on_log(msg, e);
-                }
+        sub_logs_ = bus_.subscribe<Topic::LOG>(
+            [this](const std::string& msg, const Event& e) {
+                strat_.on_log(msg, e);
         });
 
         // Heartbeats
@@ -77,13 +68,7 @@ public :
         });
         
         if(mode_ != StrategyMode::TickOnly){
-            sub_bar_ = bus_.subscribe(Topic::BAR_1S, [this](const Event& e){
-                if(!std::holds_alternative<Bar>(e.p)) {
-                    log_warn("StrategyRunner: BAR_1S event without Bar payload (seq={})",
-                             e.h.seq);
-                    return;
-                }
-                const Bar& b = std::get<Bar>(e.p);
+            sub_bar_ = bus_.subscribe<Topic::BAR_1S>([this](const Bar& b, const Event& e){
                 strat_.on_bar(b, e);
             });
         }
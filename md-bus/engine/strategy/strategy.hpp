@@ -1,5 +1,6 @@
 #pragma once 
 #include <string>
+#include <vector>
 
 #include "../common/event.hpp"
 
@@ -24,6 +25,12 @@ public :
         return "IStrategy";
     }
 
+    // symbols this strategy trades; empty means all of them. Lets the
+    // manager have the bus drop other symbols before they are queued.
+    virtual std::vector<SymbolId> symbols() const {
+        return {};
+    }
+
     virtual void finalize() {}
 };
 
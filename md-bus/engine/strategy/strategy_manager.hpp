@@ -23,6 +23,8 @@ namespace md{
  *     HEARTBEAT -> on_heartbeat()
  *     BAR_1S    -> on_bar()
  * - finalize_all() calls strategy->finalize() on all.
+ * - If every strategy names its symbols, events for any other symbol are
+ *   filtered out by the bus reactor (symbol-less LOG/HEARTBEAT still pass).
  */
 
 class StrategyManager {
@@ -32,6 +34,24 @@ private :
     SubId sub_all_{0};
     std::vector<IStrategy*> strategies_;
 
+    // union of the strategies' symbols, or no filter if any wants them all
+    EventFilter symbol_filter() const {
+        std::vector<bool> want; // indexed by SymbolId
+        for(auto* strat : strategies_){
+            auto s = strat->symbols();
+            if(s.empty()) return {};
+            for(SymbolId sym : s){
+                if(sym.id() >= want.size()) want.resize(sym.id() + 1);
+                want[sym.id()] = true;
+            }
+        }
+        if(want.empty()) return {};
+        return EventFilter{.where = [want = std::move(want)](const Event& e){
+            const uint32_t sym = symbol_of(e.p).id();
+            return sym == 0 || (sym < want.size() && want[sym]);
+        }};
+    }
+
     void on_event(const Event& e) {
         switch(e.h.topic) {
             case Topic::MD_TICK : {
@@ -110,7 +130,7 @@ public:
         started_ = true;
         sub_all_ = bus_.subscribe_all([this](const Event& e){
             this->on_event(e);
-        });
+        }, SubOptions{.name = "strategy_manager", .filter = symbol_filter()});
         log_info("StrategyManager: started with {} strategies", strategies_.size());
     }
 
@@ -1,8 +1,29 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <mutex>
+#include <random>
 #include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
 #include "../engine/bus/bus.hpp"
+#include "../engine/bus/channel.hpp"
 #include "../engine/common/event.hpp"
+#include "../engine/common/event_io.hpp"
+#include "../engine/common/mpsc_ring.hpp"
+#include "../engine/common/pod_event.hpp"
+#include "../engine/common/spsc_ring.hpp"
+#include "../engine/io/metrics_exporter.hpp"
+#include "../engine/ipc/shm_transport.hpp"
+#include "../engine/order/order_router.hpp"
+#include "../engine/replay/replay.hpp"
+#include "../engine/strategy/accounting.hpp"
 
 using namespace md;
 
@@ -72,4 +93,1479 @@ TEST(Bus, MultipleSubscribersIndependent) {
   bus.unsubscribe(tick_sub);
   bus.unsubscribe(log_sub);
   bus.stop();
-}
\ No newline at end of file
+}
+
+TEST(SpscRing, WrapsAndPreservesOrderAcrossThreads) {
+  SpscRing<uint64_t> q(100);
+  EXPECT_EQ(q.capacity(), 128u);
+
+  constexpr uint64_t N = 200000;
+  std::thread producer([&]{
+    for (uint64_t i = 0; i < N; ++i) {
+      while (!q.try_push(i)) std::this_thread::yield();
+    }
+  });
+
+  uint64_t expected = 0;
+  uint64_t v = 0;
+  while (expected < N) {
+    if (!q.try_pop(v)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ASSERT_EQ(v, expected);
+    ++expected;
+  }
+  producer.join();
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(MpscRing, ManyProducersOneConsumer) {
+  MpscRing<uint64_t> q(64);
+  constexpr int P = 4;
+  constexpr uint64_t N = 20000;
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < P; ++p) {
+    producers.emplace_back([&, p]{
+      for (uint64_t i = 0; i < N; ++i) {
+        while (!q.try_push(static_cast<uint64_t>(p) << 32 | i)) std::this_thread::yield();
+      }
+    });
+  }
+
+  // per-producer FIFO must hold even though producers interleave
+  std::vector<uint64_t> next(P, 0);
+  uint64_t got = 0;
+  uint64_t v = 0;
+  while (got < P * N) {
+    if (!q.try_pop(v)) {
+      std::this_thread::yield();
+      continue;
+    }
+    const auto p = static_cast<size_t>(v >> 32);
+    ASSERT_EQ(v & 0xffffffffu, next[p]);
+    ++next[p];
+    ++got;
+  }
+  for (auto& t : producers) t.join();
+  EXPECT_TRUE(q.empty());
+}
+
+TEST(Bus, TryPublishReportsFullIngress) {
+  EventBus bus(2, 2);
+  std::atomic<bool> release{false};
+  std::atomic<int> count{0};
+
+  // park the only subscriber so reactor and ingress back up
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){
+    while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    count.fetch_add(1);
+  });
+
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  int accepted = 0;
+  bool saw_full = false;
+  for (int i = 0; i < 64; ++i) {
+    if (bus.try_publish(Event{ .h = h, .p = Tick{.symbol="X", .pq=1.0, .qty=1} })) ++accepted;
+    else saw_full = true;
+  }
+  EXPECT_TRUE(saw_full);
+
+  // stop() drains ingress into the subscriber before tearing it down
+  release.store(true);
+  bus.stop();
+  EXPECT_EQ(count.load(), accepted);
+}
+
+TEST(Bus, BroadcastModeDeliversInOrderWithoutPerSubscriberQueues) {
+  EventBus bus(BusOptions{.ingress_cap = 64, .per_sub_cap = 8, .fanout = FanoutMode::Broadcast});
+  constexpr int N = 200;
+  std::atomic<int> ticks_a{0};
+  std::atomic<int> ticks_b{0};
+  std::atomic<int> logs{0};
+  std::atomic<int> all{0};
+  std::atomic<bool> in_order{true};
+  double last_px = 0.0;
+
+  bus.subscribe(Topic::MD_TICK, [&](const Event& e){
+    const auto* t = std::get_if<Tick>(&e.p);
+    if (!t) return;
+    if (t->pq <= last_px) in_order.store(false);
+    last_px = t->pq.to_double();
+    ticks_a.fetch_add(1);
+  });
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){ ticks_b.fetch_add(1); });
+  bus.subscribe(Topic::LOG, [&](const Event&){ logs.fetch_add(1); });
+  bus.subscribe_all([&](const Event&){ all.fetch_add(1); });
+
+  Header th{};
+  th.topic = Topic::MD_TICK;
+  Header lh{};
+  lh.topic = Topic::LOG;
+  // ring is much smaller than N, so the reactor must be gated by readers
+  for (int i = 0; i < N; ++i) {
+    bus.publish(Event{ .h = th, .p = Tick{.symbol="X", .pq=1.0 + i, .qty=1} });
+    bus.publish(Event{ .h = lh, .p = std::string("log") });
+  }
+  bus.stop();
+
+  EXPECT_TRUE(in_order.load());
+  EXPECT_EQ(ticks_a.load(), N);
+  EXPECT_EQ(ticks_b.load(), N);
+  EXPECT_EQ(logs.load(), N);
+  EXPECT_EQ(all.load(), 2 * N);
+}
+
+TEST(Bus, BroadcastBatchLargerThanRingWakesParkedReader) {
+  // a reactor batch bigger than the ring must ring parked readers while it
+  // waits for them, or it fills the ring and waits forever
+  EventBus bus(BusOptions{.ingress_cap = 256, .per_sub_cap = 8, .fanout = FanoutMode::Broadcast});
+  constexpr int N = 100;
+  std::atomic<int> got{0};
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){ got.fetch_add(1); },
+                SubOptions{.wait = WaitStrategy::SpinPark});
+  std::this_thread::sleep_for(std::chrono::milliseconds(50)); // let it park
+
+  std::vector<Event> evs(N);
+  for (int i = 0; i < N; ++i) {
+    evs[i].h.topic = Topic::MD_TICK;
+    evs[i].p = Tick{.symbol = "X", .pq = 1.0 + i, .qty = 1};
+  }
+  ASSERT_TRUE(bus.publish_batch(evs.data(), evs.size()));
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (got.load() < N && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(got.load(), N);
+  bus.stop();
+}
+
+TEST(Bus, SubscriptionChurnDoesNotStallRouting) {
+  EventBus bus(1024, 1024);
+  std::atomic<int> risk{0};
+  bus.subscribe(Topic::RISK_ALERT, [&](const Event&){ risk.fetch_add(1); });
+
+  std::atomic<bool> done{false};
+  std::thread churn([&]{
+    while (!done.load()) {
+      auto id = bus.subscribe(Topic::MD_TICK, [](const Event&){});
+      bus.unsubscribe(id);
+    }
+  });
+
+  Header h{};
+  h.topic = Topic::RISK_ALERT;
+  for (int i = 0; i < 500; ++i) {
+    bus.publish(Event{ .h = h, .p = RiskAlert{.symbol="X", .code=i, .reason="r"} });
+  }
+  done.store(true);
+  churn.join();
+  bus.stop();
+  EXPECT_EQ(risk.load(), 500);
+}
+
+TEST(Bus, WorkerPoolKeepsPerSubscriptionOrder) {
+  EventBus bus(BusOptions{.ingress_cap = 1024, .per_sub_cap = 64, .worker_threads = 2});
+  constexpr int kSubs = 16;
+  constexpr int N = 500;
+  std::vector<std::atomic<int>> counts(kSubs);
+  std::atomic<bool> in_order{true};
+  std::vector<double> last(kSubs, 0.0);
+  std::vector<SubId> ids;
+
+  for (int i = 0; i < kSubs; ++i) {
+    ids.push_back(bus.subscribe(Topic::MD_TICK, [&, i](const Event& e){
+      const auto* t = std::get_if<Tick>(&e.p);
+      if (!t) return;
+      if (t->pq <= last[i]) in_order.store(false);
+      last[i] = t->pq.to_double();
+      counts[i].fetch_add(1);
+    }));
+  }
+
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  for (int i = 0; i < N; ++i) {
+    bus.publish(Event{ .h = h, .p = Tick{.symbol="X", .pq=1.0 + i, .qty=1} });
+  }
+
+  // unsubscribing one strand mid-stream must not disturb the others
+  bus.unsubscribe(ids.back());
+  bus.stop();
+
+  EXPECT_TRUE(in_order.load());
+  for (int i = 0; i + 1 < kSubs; ++i) EXPECT_EQ(counts[i].load(), N);
+}
+
+TEST(Bus, WorkerPoolCallbackCanUnsubscribe) {
+  // one worker: a callback waiting for any strand to retire would block the
+  // only thread that can retire it
+  EventBus bus(BusOptions{.ingress_cap = 1024, .per_sub_cap = 64, .worker_threads = 1});
+  std::atomic<int> self_calls{0};
+  std::atomic<int> other_calls{0};
+  std::atomic<SubId> self_id{0};
+  std::atomic<SubId> other_id{0};
+  std::atomic<bool> unsubscribed{false};
+
+  other_id = bus.subscribe(Topic::LOG, [&](const Event&){ other_calls.fetch_add(1); });
+  self_id = bus.subscribe(Topic::MD_TICK, [&](const Event&){
+    if (self_calls.fetch_add(1) == 0) {
+      bus.unsubscribe(other_id.load());
+      bus.unsubscribe(self_id.load());
+      unsubscribed.store(true);
+    }
+  });
+
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  bus.publish(Event{ .h = h, .p = Tick{.symbol="X", .pq=1.0, .qty=1} });
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!unsubscribed.load() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_TRUE(unsubscribed.load());
+
+  // both are gone: nothing more reaches them, and the bus still stops
+  for (int i = 0; i < 10; ++i) {
+    bus.publish(Event{ .h = h, .p = Tick{.symbol="X", .pq=2.0, .qty=1} });
+    Header lh{};
+    lh.topic = Topic::LOG;
+    bus.publish(Event{ .h = lh, .p = std::string("log") });
+  }
+  bus.stop();
+  EXPECT_EQ(self_calls.load(), 1);
+  EXPECT_EQ(other_calls.load(), 0);
+}
+
+TEST(Bus, PublishBatchAssignsConsecutiveSeqsInOrder) {
+  EventBus bus(64, 1024);
+  std::vector<uint64_t> seqs;
+  std::vector<double> pxs;
+  std::mutex mu;
+  bus.subscribe(Topic::MD_TICK, [&](const Event& e){
+    std::scoped_lock lk(mu);
+    seqs.push_back(e.h.seq);
+    pxs.push_back(std::get<Tick>(e.p).pq.to_double());
+  });
+
+  // larger than ingress, so it has to go in several chunks
+  constexpr size_t N = 300;
+  std::vector<Event> batch(N);
+  for (size_t i = 0; i < N; ++i) {
+    batch[i].h.topic = Topic::MD_TICK;
+    batch[i].p = Tick{.symbol="X", .pq=static_cast<double>(i), .qty=1};
+  }
+  ASSERT_TRUE(bus.publish_batch(batch.data(), batch.size()));
+  bus.stop();
+
+  ASSERT_EQ(seqs.size(), N);
+  for (size_t i = 0; i < N; ++i) {
+    EXPECT_EQ(seqs[i], seqs[0] + i);
+    EXPECT_EQ(pxs[i], static_cast<double>(i));
+  }
+}
+
+TEST(Bus, OverflowPoliciesKeepSlowSubscriberFromStallingOthers) {
+  EventBus bus(1024, 1024);
+  std::atomic<bool> release{false};
+  std::atomic<int> fast{0};
+  std::vector<double> oldest_seen;
+  std::vector<double> conflated_seen;
+  std::mutex mu;
+
+  auto park = [&]{ while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1)); };
+
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){ fast.fetch_add(1); });
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){ park(); },
+                SubOptions{.overflow = OverflowPolicy::DropNewest, .capacity = 4, .name = "newest"});
+  bus.subscribe(Topic::MD_TICK, [&](const Event& e){
+    park();
+    std::scoped_lock lk(mu);
+    oldest_seen.push_back(std::get<Tick>(e.p).pq.to_double());
+  }, SubOptions{.overflow = OverflowPolicy::DropOldest, .capacity = 4, .name = "oldest"});
+  bus.subscribe(Topic::MD_TICK, [&](const Event& e){
+    park();
+    std::scoped_lock lk(mu);
+    conflated_seen.push_back(std::get<Tick>(e.p).pq.to_double());
+  }, SubOptions{.overflow = OverflowPolicy::Conflate, .capacity = 4, .name = "conflate"});
+
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  constexpr int N = 100;
+  for (int i = 0; i < N; ++i) {
+    bus.publish(Event{ .h = h, .p = Tick{.symbol="X", .pq=static_cast<double>(i), .qty=1} });
+  }
+
+  // the Block subscriber must get everything while the others are parked
+  for (int i = 0; i < 200 && fast.load() < N; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(fast.load(), N);
+
+  auto snap = bus.perf_snapshot();
+  EXPECT_GT(snap.dropped, 0u);
+  EXPECT_EQ(snap.drops.size(), 3u);
+
+  release.store(true);
+  bus.stop();
+
+  // both lossy queues must end on the latest value
+  ASSERT_FALSE(oldest_seen.empty());
+  ASSERT_FALSE(conflated_seen.empty());
+  EXPECT_EQ(oldest_seen.back(), N - 1);
+  EXPECT_EQ(conflated_seen.back(), N - 1);
+  EXPECT_LE(oldest_seen.size(), 6u);
+}
+
+TEST(Bus, UnsubscribeKeepsDropsInTotalsWithoutAGap) {
+  EventBus bus(1024, 1024);
+  std::atomic<bool> release{false};
+  const SubId id = bus.subscribe(Topic::MD_TICK, [&](const Event&){
+    while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }, SubOptions{.overflow = OverflowPolicy::DropNewest, .capacity = 4, .name = "slow"});
+
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  constexpr int N = 100;
+  for (int i = 0; i < N; ++i) {
+    bus.publish(Event{ .h = h, .p = Tick{.symbol="X", .pq=static_cast<double>(i), .qty=1} });
+  }
+  // parked on one, a few queued, the rest dropped: wait for the count to settle
+  uint64_t dropped = 0;
+  for (int i = 0, still = 0; i < 400 && still < 5; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    const uint64_t d = bus.perf_snapshot().dropped;
+    still = (d > 0 && d == dropped) ? still + 1 : 0;
+    dropped = d;
+  }
+  ASSERT_GT(dropped, 0u);
+
+  // while unsubscribe() waits for the parked callback, totals don't dip
+  std::thread t([&]{ bus.unsubscribe(id); });
+  for (int i = 0; i < 20; ++i) {
+    const auto snap = bus.perf_snapshot();
+    EXPECT_EQ(snap.dropped, dropped);
+    EXPECT_EQ(snap.subscribers.size(), 1u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  release.store(true);
+  t.join();
+
+  // gone from the live list, its drops kept in the bus total
+  const auto snap = bus.perf_snapshot();
+  EXPECT_EQ(snap.dropped, dropped);
+  EXPECT_TRUE(snap.subscribers.empty());
+  EXPECT_TRUE(snap.drops.empty());
+  bus.stop();
+}
+
+TEST(Bus, ConflatePolicyOnlyReplacesSameTopicAndSymbol) {
+  EventBus bus(1024, 1024);
+  std::atomic<bool> parked{false};
+  std::atomic<bool> release{false};
+  std::vector<std::string> seen;
+  std::mutex mu;
+
+  bus.subscribe_all([&](const Event& e){
+    if (!parked.exchange(true)) {
+      while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::scoped_lock lk(mu);
+    if (const auto* t = std::get_if<Tick>(&e.p)) {
+      seen.push_back(t->symbol.name() + std::to_string(static_cast<int>(t->pq.to_double())));
+    } else if (const auto* msg = std::get_if<std::string>(&e.p)) {
+      seen.push_back(*msg);
+    }
+  }, SubOptions{.overflow = OverflowPolicy::Conflate, .capacity = 4, .name = "conflate"});
+
+  Header th{};
+  th.topic = Topic::MD_TICK;
+  Header lh{};
+  lh.topic = Topic::LOG;
+  auto tick = [&](const char* sym, double px){
+    bus.publish(Event{ .h = th, .p = Tick{.symbol = sym, .pq = px, .qty = 1} });
+  };
+  tick("A", 0);
+  while (!parked.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  // fills the queue in order
+  tick("A", 1);
+  tick("B", 1);
+  bus.publish(Event{ .h = lh, .p = std::string("log1") });
+  tick("C", 1);
+  // full: same key replaces its newest queued event, anything else is dropped
+  tick("A", 2);
+  tick("B", 2);
+  tick("D", 1);
+  bus.publish(Event{ .h = lh, .p = std::string("log2") });
+  tick("A", 3);
+
+  for (int i = 0; i < 200 && bus.perf_snapshot().dropped < 5; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(bus.perf_snapshot().dropped, 5u);
+  release.store(true);
+  bus.stop();
+
+  EXPECT_EQ(seen, (std::vector<std::string>{"A0", "A3", "B2", "log1", "C1"}));
+}
+
+TEST(Bus, ConflateBySymbolKeepsLatestPerSymbol) {
+  EventBus bus(1024, 1024);
+  std::atomic<bool> release{false};
+  std::atomic<bool> first{true};
+  std::vector<std::pair<std::string, double>> seen;
+  std::mutex mu;
+
+  bus.subscribe(Topic::MD_TICK, [&](const Event& e){
+    // park on the first event so everything after it piles up
+    if (first.exchange(false)) {
+      while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const auto& t = std::get<Tick>(e.p);
+    std::scoped_lock lk(mu);
+    seen.emplace_back(t.symbol.name(), t.pq.to_double());
+  }, SubOptions{.name = "latest", .conflate_by_symbol = true});
+
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  const char* syms[] = {"A", "B", "C"};
+  constexpr int N = 300;
+  for (int i = 0; i < N; ++i) {
+    bus.publish(Event{ .h = h, .p = Tick{.symbol = syms[i % 3], .pq = static_cast<double>(i), .qty = 1} });
+  }
+  // let the reactor route the whole burst into the parked subscriber
+  for (int i = 0; i < 200 && bus.perf_snapshot().dropped + 3 < N - 1; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  release.store(true);
+  bus.stop();
+
+  // the event it parked on + at most one pending per symbol (3 if the
+  // worker only woke up after the whole burst was already conflated)
+  ASSERT_GE(seen.size(), 3u);
+  EXPECT_LE(seen.size(), 4u);
+  std::unordered_map<std::string, double> last;
+  for (const auto& [s, px] : seen) last[s] = px;
+  EXPECT_EQ(last["A"], N - 3);
+  EXPECT_EQ(last["B"], N - 2);
+  EXPECT_EQ(last["C"], N - 1);
+}
+
+TEST(Bus, WaitStrategiesDeliverAndShowInStats) {
+  BusOptions o;
+  o.ingress_cap = 1024;
+  o.per_sub_cap = 1024;
+  o.reactor_wait = WaitStrategy::SpinYield;
+  EventBus bus(o);
+
+  std::atomic<int> spin{0}, park{0};
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){ spin.fetch_add(1); },
+                SubOptions{.name = "hot", .wait = WaitStrategy::BusySpin});
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){ park.fetch_add(1); });
+
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  constexpr int N = 100;
+  for (int i = 0; i < N; ++i) {
+    bus.publish(Event{ .h = h, .p = Tick{.symbol = "X", .pq = 1.0, .qty = 1} });
+  }
+  for (int i = 0; i < 200 && (spin.load() < N || park.load() < N); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(spin.load(), N);
+  EXPECT_EQ(park.load(), N);
+
+  auto snap = bus.perf_snapshot();
+  EXPECT_EQ(snap.reactor_wait, WaitStrategy::SpinYield);
+  EXPECT_EQ(snap.worker_wait, WaitStrategy::SpinPark);
+  bus.stop();
+}
+
+TEST(Bus, ThreadConfigNamesBusThreads) {
+  BusOptions o;
+  o.reactor_thread.cpu = 0;
+  EventBus bus(o);
+
+  std::atomic<bool> done{false};
+  std::string name;
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){
+#if defined(__linux__)
+    char buf[16] = {};
+    pthread_getname_np(pthread_self(), buf, sizeof(buf));
+    name = buf;
+#endif
+    done.store(true);
+  }, SubOptions{.name = "ticks", .thread = ThreadConfig{.name = "md-ticks", .cpu = 0}});
+
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  bus.publish(Event{ .h = h, .p = Tick{.symbol = "X", .pq = 1.0, .qty = 1} });
+  for (int i = 0; i < 200 && !done.load(); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_TRUE(done.load());
+#if defined(__linux__)
+  EXPECT_EQ(name, "md-ticks");
+#endif
+  EXPECT_TRUE(bus.pin_reactor(0));
+  EXPECT_FALSE(bus.pin_subscription(12345, 0));
+  bus.stop();
+}
+
+TEST(Bus, SharedEventsHandOutOneCopyPerEvent) {
+  BusOptions o;
+  o.ingress_cap = 1024;
+  o.per_sub_cap = 1024;
+  o.shared_events = true;
+  EventBus bus(o);
+
+  constexpr int N = 1000;
+  std::mutex mu;
+  std::vector<std::vector<std::pair<uint64_t, const Event*>>> seen(3);
+  auto record = [&](int k){
+    return [&, k](const Event& e){
+      std::scoped_lock lk(mu);
+      seen[k].emplace_back(e.h.seq, &e);
+    };
+  };
+  bus.subscribe(Topic::MD_TICK, record(0));
+  bus.subscribe(Topic::MD_TICK, record(1), SubOptions{.overflow = OverflowPolicy::DropOldest});
+  bus.subscribe_all(record(2));
+
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  for (int i = 0; i < N; ++i) {
+    bus.publish(Event{ .h = h, .p = Tick{.symbol = "X", .pq = static_cast<double>(i), .qty = 1} });
+  }
+  bus.stop();
+
+  for (auto& v : seen) {
+    ASSERT_EQ(v.size(), static_cast<size_t>(N));
+    for (size_t i = 1; i < v.size(); ++i) EXPECT_LT(v[i - 1].first, v[i].first);
+  }
+  // copies would live in each subscriber's own scratch slot; shared events
+  // hand all three the same envelope
+  size_t same = 0;
+  for (int i = 0; i < N; ++i) {
+    if (seen[0][i].second == seen[1][i].second && seen[1][i].second == seen[2][i].second) ++same;
+  }
+  EXPECT_GT(same, 0u);
+}
+
+TEST(Bus, ShardedReactorsKeepPerSymbolOrder) {
+  BusOptions o;
+  o.ingress_cap = 1024;
+  o.per_sub_cap = 4096;
+  o.reactor_shards = 4;
+  EventBus bus(o);
+  ASSERT_EQ(bus.shard_count(), 4u);
+
+  std::mutex mu;
+  std::unordered_map<std::string, std::vector<double>> by_sym;
+  std::vector<std::string> shard1;
+  bus.subscribe(Topic::MD_TICK, [&](const Event& e){
+    const auto& t = std::get<Tick>(e.p);
+    std::scoped_lock lk(mu);
+    by_sym[t.symbol.name()].push_back(t.pq.to_double());
+  });
+  bus.subscribe(Topic::MD_TICK, [&](const Event& e){
+    std::scoped_lock lk(mu);
+    shard1.push_back(std::get<Tick>(e.p).symbol.name());
+  }, SubOptions{.name = "shard1", .shards = {1}});
+
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  constexpr int kSyms = 20;
+  constexpr int N = 2000;
+  std::vector<Event> batch;
+  for (int i = 0; i < N; ++i) {
+    Event e{ .h = h, .p = Tick{.symbol = "S" + std::to_string(i % kSyms), .pq = static_cast<double>(i), .qty = 1} };
+    if (i < N / 2) {
+      bus.publish(std::move(e));
+    } else {
+      batch.push_back(std::move(e));
+      if (batch.size() == 50) {
+        bus.publish_batch(batch.data(), batch.size());
+        batch.clear();
+      }
+    }
+  }
+  bus.stop();
+
+  ASSERT_EQ(by_sym.size(), static_cast<size_t>(kSyms));
+  for (auto& [sym, px] : by_sym) {
+    ASSERT_EQ(px.size(), static_cast<size_t>(N / kSyms)) << sym;
+    for (size_t i = 1; i < px.size(); ++i) EXPECT_LT(px[i - 1], px[i]) << sym;
+  }
+  for (const auto& sym : shard1) {
+    Event probe{ .h = h, .p = Tick{.symbol = sym} };
+    EXPECT_EQ(bus.shard_of(probe), 1u);
+  }
+
+  auto snap = bus.perf_snapshot();
+  ASSERT_EQ(snap.shard_routed.size(), 4u);
+  uint64_t routed = 0;
+  for (auto r : snap.shard_routed) routed += r;
+  EXPECT_EQ(routed, static_cast<uint64_t>(N));
+}
+
+TEST(Bus, InlineModeRunsCallbacksOnPublisherInOrder) {
+  BusOptions o;
+  o.exec = ExecMode::Inline;
+  EventBus bus(o);
+
+  const auto me = std::this_thread::get_id();
+  std::vector<std::string> trace;
+  bus.subscribe(Topic::MD_TICK, [&](const Event& e){
+    EXPECT_EQ(std::this_thread::get_id(), me);
+    const auto& t = std::get<Tick>(e.p);
+    trace.push_back("tick:" + std::to_string(static_cast<int>(t.pq.to_double())));
+    // recursive publish: queued, runs before the outer publish returns
+    Header h{};
+    h.topic = Topic::TRADE;
+    bus.publish(Event{ .h = h, .p = Trade{.symbol = t.symbol, .price = t.pq} });
+  });
+  bus.subscribe(Topic::TRADE, [&](const Event& e){
+    trace.push_back("trade:" + std::to_string(static_cast<int>(std::get<Trade>(e.p).price.to_double())));
+  });
+  bus.subscribe_all([&](const Event& e){
+    trace.push_back(std::string("all:") + to_string(e.h.topic));
+  });
+
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  bus.publish(Event{ .h = h, .p = Tick{.symbol = "X", .pq = 1.0, .qty = 1} });
+  const std::vector<std::string> after_one = {"tick:1", "all:MD_TICK", "trade:1", "all:TRADE"};
+  EXPECT_EQ(trace, after_one);
+
+  std::vector<Event> batch;
+  batch.push_back(Event{ .h = h, .p = Tick{.symbol = "X", .pq = 2.0, .qty = 1} });
+  batch.push_back(Event{ .h = h, .p = Tick{.symbol = "Y", .pq = 3.0, .qty = 1} });
+  bus.publish_batch(batch.data(), batch.size());
+  const std::vector<std::string> all = {
+    "tick:1", "all:MD_TICK", "trade:1", "all:TRADE",
+    "tick:2", "all:MD_TICK", "tick:3", "all:MD_TICK",
+    "trade:2", "all:TRADE", "trade:3", "all:TRADE"};
+  EXPECT_EQ(trace, all);
+
+  bus.stop();
+  EXPECT_FALSE(bus.publish(Event{ .h = h, .p = Tick{.symbol = "X"} }));
+}
+
+TEST(Bus, SnapshotBreaksDownLatencyBySubscriberAndTopic) {
+  EventBus bus(1024, 1024);
+  std::atomic<bool> release{false};
+  std::atomic<int> got{0};
+
+  auto fast = bus.subscribe(Topic::MD_TICK, [&](const Event&){ got.fetch_add(1); },
+                            SubOptions{.name = "fast"});
+  auto slow = bus.subscribe(Topic::MD_TICK, [&](const Event&){
+    while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+    got.fetch_add(1);
+  }, SubOptions{.name = "slow"});
+  bus.subscribe(Topic::LOG, [&](const Event&){ got.fetch_add(1); }, SubOptions{.name = "logs"});
+
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  constexpr int N = 20;
+  for (int i = 0; i < N; ++i) {
+    bus.publish(Event{ .h = h, .p = Tick{.symbol = "X", .pq = 1.0, .qty = 1} });
+  }
+  Header lh{};
+  lh.topic = Topic::LOG;
+  bus.publish(Event{ .h = lh, .p = std::string("hello") });
+
+  // the slow one is parked on its first event: the rest sits in its queue
+  for (int i = 0; i < 200 && got.load() < N + 1; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  release.store(true);
+  for (int i = 0; i < 400 && got.load() < 2 * N + 1; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_EQ(got.load(), 2 * N + 1);
+
+  auto snap = bus.perf_snapshot();
+  ASSERT_EQ(snap.subscribers.size(), 3u);
+  const auto& f = snap.subscribers[0];
+  const auto& s = snap.subscribers[1];
+  EXPECT_EQ(f.id, fast);
+  EXPECT_EQ(s.id, slow);
+  EXPECT_EQ(f.delivered, static_cast<uint64_t>(N));
+  EXPECT_EQ(s.delivered, static_cast<uint64_t>(N));
+  EXPECT_EQ(s.latency.count, static_cast<uint64_t>(N));
+  EXPECT_GE(s.callback.p50, 100'000u);
+  EXPECT_LT(f.callback.p50, s.callback.p50);
+  EXPECT_GT(s.depth_hwm, 1u);
+  EXPECT_EQ(s.depth, 0u);
+
+  ASSERT_EQ(snap.topics.size(), 2u);
+  for (const auto& t : snap.topics) {
+    if (t.topic == Topic::MD_TICK) {
+      EXPECT_EQ(t.routed, static_cast<uint64_t>(N));
+      EXPECT_EQ(t.latency.count, static_cast<uint64_t>(2 * N));
+    } else {
+      EXPECT_EQ(t.topic, Topic::LOG);
+      EXPECT_EQ(t.latency.count, 1u);
+    }
+  }
+  bus.stop();
+}
+
+TEST(Bus, PerfSamplingTimesOneInNAndSurvivesUnsubscribe) {
+  BusOptions o;
+  o.perf_sample_every = 4;
+  EventBus bus(o);
+  std::atomic<int> got{0};
+  auto id = bus.subscribe(Topic::MD_TICK, [&](const Event&){ got.fetch_add(1); });
+
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  constexpr int N = 100;
+  for (int i = 0; i < N; ++i) {
+    bus.publish(Event{ .h = h, .p = Tick{.symbol = "X", .pq = 1.0, .qty = 1} });
+  }
+  for (int i = 0; i < 200 && got.load() < N; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_EQ(got.load(), N);
+
+  auto snap = bus.perf_snapshot();
+  ASSERT_EQ(snap.subscribers.size(), 1u);
+  EXPECT_EQ(snap.subscribers[0].delivered, static_cast<uint64_t>(N));
+  EXPECT_EQ(snap.subscribers[0].latency.count, static_cast<uint64_t>(N / 4));
+  EXPECT_EQ(snap.events, static_cast<uint64_t>(N));
+
+  // an unsubscribed slot's numbers stay in the bus totals
+  bus.unsubscribe(id);
+  snap = bus.perf_snapshot();
+  EXPECT_TRUE(snap.subscribers.empty());
+  EXPECT_EQ(snap.events, static_cast<uint64_t>(N));
+  ASSERT_EQ(snap.topics.size(), 1u);
+  EXPECT_EQ(snap.topics[0].latency.count, static_cast<uint64_t>(N / 4));
+  bus.stop();
+}
+
+TEST(HdrHistogram, PercentilesMatchExactSortedSamples) {
+  std::mt19937_64 rng(42);
+  // latency-like: mostly sub-microsecond, a long tail up to tens of ms
+  std::lognormal_distribution<double> dist(7.0, 1.5);
+  std::vector<uint64_t> xs;
+  LatencyHistogram a, b;
+  for (int i = 0; i < 200'000; ++i) {
+    const uint64_t v = static_cast<uint64_t>(dist(rng)) + 1;
+    xs.push_back(v);
+    (i % 2 ? a : b).record(v);
+  }
+  a.merge(b);
+  std::sort(xs.begin(), xs.end());
+
+  ASSERT_EQ(a.n, xs.size());
+  EXPECT_EQ(a.min_v, xs.front());
+  EXPECT_EQ(a.max_v, xs.back());
+  const double tol = 1.0 / LatencyHistogram::Layout::half;
+  for (double p : {0.01, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 0.9999}) {
+    const size_t rank = static_cast<size_t>(std::ceil(p * xs.size()));
+    const double exact = static_cast<double>(xs[rank - 1]);
+    const double got = static_cast<double>(a.percentile(p));
+    EXPECT_GE(got, exact) << "p=" << p;
+    EXPECT_LE(got, exact * (1.0 + tol) + 1.0) << "p=" << p;
+  }
+}
+
+TEST(Metrics, PrometheusAndJsonFormats) {
+  MetricsRegistry reg;
+  reg.add("a", [](MetricSet& m){
+    m.counter("md_x_total", 3, {{"k", "v\"1"}});
+    m.gauge("md_depth", 1.5);
+  });
+  reg.add("b", [](MetricSet& m){ m.counter("md_x_total", 4); });
+
+  const MetricSet set = reg.collect();
+  ASSERT_EQ(set.size(), 3u);
+
+  // samples of one name stay together under a single TYPE line
+  EXPECT_EQ(format_prometheus(set),
+            "# TYPE md_depth gauge\n"
+            "md_depth{source=\"a\"} 1.5\n"
+            "# TYPE md_x_total counter\n"
+            "md_x_total{source=\"a\",k=\"v\\\"1\"} 3\n"
+            "md_x_total{source=\"b\"} 4\n");
+
+  EXPECT_EQ(format_json_line(set, 7),
+            "{\"ts_ns\":7,\"metrics\":["
+            "{\"name\":\"md_x_total\",\"type\":\"counter\",\"labels\":{\"source\":\"a\",\"k\":\"v\\\"1\"},\"value\":3},"
+            "{\"name\":\"md_depth\",\"type\":\"gauge\",\"labels\":{\"source\":\"a\"},\"value\":1.5},"
+            "{\"name\":\"md_x_total\",\"type\":\"counter\",\"labels\":{\"source\":\"b\"},\"value\":4}]}\n");
+}
+
+TEST(Metrics, ExporterWritesBusCountersToFile) {
+  EventBus bus(BusOptions{.exec = ExecMode::Inline});
+  std::atomic<int> got{0};
+  auto id = bus.subscribe(Topic::MD_TICK, [&](const Event&){ got.fetch_add(1); },
+                          SubOptions{.name = "ticks"});
+  for (int i = 0; i < 10; ++i) {
+    Header h{};
+    h.topic = Topic::MD_TICK;
+    bus.publish(Event{.h = h, .p = Tick{.symbol = "NIFTY", .pq = 1.0, .qty = 1}});
+  }
+  ASSERT_EQ(got.load(), 10);
+
+  MetricsRegistry reg;
+  reg.add("bus", [&bus](MetricSet& m){ bus.collect_metrics(m); });
+
+  const std::string path = ::testing::TempDir() + "md_metrics_test.prom";
+  std::remove(path.c_str());
+  MetricsExporter ex(reg, ExportOptions{.path = path, .interval = std::chrono::milliseconds(10)});
+  ex.start();
+  while (ex.exports() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  ex.stop();
+  EXPECT_EQ(ex.failures(), 0u);
+
+  std::ifstream in(path);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  const std::string text = ss.str();
+  EXPECT_NE(text.find("md_bus_published_total{source=\"bus\"} 10\n"), std::string::npos) << text;
+  EXPECT_NE(text.find("md_bus_topic_routed_total{source=\"bus\",topic=\"MD_TICK\"} 10\n"), std::string::npos);
+  EXPECT_NE(text.find("md_bus_sub_delivered_total{source=\"bus\",sub=\"" + std::to_string(id) +
+                      "\",name=\"ticks\"} 10\n"), std::string::npos);
+  EXPECT_NE(text.find("md_bus_sub_latency_ns{source=\"bus\",sub=\"" + std::to_string(id) +
+                      "\",name=\"ticks\",quantile=\"0.99\"}"), std::string::npos);
+  std::remove(path.c_str());
+
+  // JSON lines carry wall-clock (Unix epoch) time, so they line up with
+  // other data; not the bus's monotonic clock
+  const std::string jpath = ::testing::TempDir() + "md_metrics_test.jsonl";
+  std::remove(jpath.c_str());
+  MetricsExporter jx(reg, ExportOptions{.format = ExportFormat::JsonLines, .path = jpath});
+  const uint64_t before = wall_now_ns();
+  ASSERT_TRUE(jx.export_now());
+  const uint64_t after = wall_now_ns();
+  std::ifstream jin(jpath);
+  std::string line;
+  ASSERT_TRUE(std::getline(jin, line));
+  ASSERT_EQ(line.rfind("{\"ts_ns\":", 0), 0u) << line;
+  const uint64_t ts = std::stoull(line.substr(9));
+  EXPECT_GE(ts, before);
+  EXPECT_LE(ts, after);
+  std::remove(jpath.c_str());
+
+  bus.unsubscribe(id);
+  bus.stop();
+}
+
+TEST(Bus, StopWakesParkedReactorAndZeroHeaderEventsAreData) {
+  // an all-zero header used to be the shutdown sentinel and was dropped
+  const std::string path = ::testing::TempDir() + "md_zero_header.log";
+  {
+    std::ofstream out(path, std::ios::trunc);
+    Event e;
+    e.h.topic = Topic::MD_TICK;
+    e.p = Tick{.symbol = "NIFTY", .pq = 1.0, .qty = 1};
+    out << serialize_event(e) << '\n';
+  }
+
+  EventBus bus(BusOptions{.reactor_wait = WaitStrategy::SpinPark});
+  std::atomic<int> got{0};
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){ got.fetch_add(1); });
+
+  EventReplay replay(path);
+  replay.replay_fast(bus);
+  EXPECT_EQ(replay.events_published(), 1u);
+  for (int i = 0; i < 2000 && got.load() < 1; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(got.load(), 1);
+
+  // reactor is parked on its bell by now; stop() must get it out with no
+  // event in ingress
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  bus.stop();
+  EXPECT_EQ(bus.perf_snapshot().topics.size(), 1u);
+  std::remove(path.c_str());
+}
+
+TEST(Bus, FiltersRunInReactorBySymbolPriceAndPredicate) {
+  EventBus bus(BusOptions{.reactor_shards = 2});
+  std::mutex mu;
+  std::vector<std::string> a_got, all_got;
+  std::atomic<int> px_got{0}, where_got{0}, plain_got{0};
+
+  bus.subscribe(Topic::MD_TICK, [&](const Event& e){
+    std::scoped_lock lk(mu);
+    a_got.push_back(std::get<Tick>(e.p).symbol.name());
+  }, SubOptions{.name = "a", .filter = {.symbols = {"S1", "S3", "S1"}}});
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){ px_got.fetch_add(1); },
+                          SubOptions{.filter = {.symbols = {"S2"}, .min_price = 10.0, .min_qty = 5}});
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){ where_got.fetch_add(1); },
+                          SubOptions{.filter = {.where = [](const Event& e){
+                            return std::get<Tick>(e.p).qty % 2 == 0; }}});
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){ plain_got.fetch_add(1); });
+  bus.subscribe_all([&](const Event& e){
+    std::scoped_lock lk(mu);
+    all_got.push_back(to_string(e.h.topic));
+  }, SubOptions{.filter = {.symbols = {"S4"}}});
+
+  const int N = 400;
+  for (int i = 0; i < N; ++i) {
+    Header h{};
+    h.topic = Topic::MD_TICK;
+    const std::string sym = "S" + std::to_string(i % 5);
+    bus.publish(Event{.h = h, .p = Tick{.symbol = sym, .pq = static_cast<double>(i % 20),
+                                        .qty = static_cast<uint32_t>(i % 10)}});
+  }
+  Header lh{};
+  lh.topic = Topic::LOG;
+  bus.publish(Event{.h = lh, .p = std::string{"no symbol"}});
+
+  for (int i = 0; i < 2000 && plain_got.load() < N; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  bus.stop();
+
+  // S1 and S3 once each per 5 events, even though S1 is listed twice
+  ASSERT_EQ(a_got.size(), static_cast<size_t>(2 * N / 5));
+  for (const auto& s : a_got) EXPECT_TRUE(s == "S1" || s == "S3") << s;
+  int want_px = 0;
+  for (int i = 0; i < N; ++i) {
+    if (i % 5 == 2 && i % 20 >= 10 && i % 10 >= 5) ++want_px;
+  }
+  EXPECT_EQ(px_got.load(), want_px);
+  EXPECT_EQ(where_got.load(), N / 2);
+  EXPECT_EQ(plain_got.load(), N);
+  // the LOG event has no symbol, so a symbol filter rejects it
+  EXPECT_EQ(all_got.size(), static_cast<size_t>(N / 5));
+}
+
+TEST(Bus, FilteredAndPlainSubscribersKeepSubscriptionOrderInline) {
+  EventBus bus(BusOptions{.exec = ExecMode::Inline});
+  std::vector<int> order;
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){ order.push_back(1); });
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){ order.push_back(2); },
+                SubOptions{.filter = {.symbols = {"X"}}});
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){ order.push_back(3); });
+  bus.subscribe(Topic::MD_TICK, [&](const Event&){ order.push_back(4); },
+                SubOptions{.filter = {.symbols = {"X", "Y"}}});
+
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  bus.publish(Event{.h = h, .p = Tick{.symbol = "X", .pq = 1.0, .qty = 1}});
+  bus.publish(Event{.h = h, .p = Tick{.symbol = "Y", .pq = 1.0, .qty = 1}});
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 3, 4, 1, 3, 4}));
+  bus.stop();
+}
+
+static_assert(std::is_same_v<payload_t<Topic::BAR_1M>, Bar>);
+static_assert(std::is_same_v<payload_t<Topic::RISK_ALERT>, RiskAlert>);
+
+TEST(Bus, TypedPublishSubscribeMapsTopicToPayload) {
+  EventBus bus(BusOptions{.exec = ExecMode::Inline});
+  std::vector<std::string> syms;
+  std::vector<uint64_t> seqs;
+  int alerts = 0;
+  bus.subscribe<Topic::MD_TICK>([&](const Tick& t){ syms.push_back(t.symbol.name()); });
+  bus.subscribe<Topic::MD_TICK>([&](const Tick&, const Event& e){ seqs.push_back(e.h.seq); });
+  bus.subscribe<Topic::RISK_ALERT>([&](const RiskAlert& r){ alerts += r.code; });
+
+  bus.publish<Topic::MD_TICK>(Tick{.symbol = "A", .pq = 1.0, .qty = 1});
+  bus.publish<Topic::RISK_ALERT>(RiskAlert{.symbol = "A", .code = 7, .reason = "x"});
+  bus.publish<Topic::MD_TICK>(Tick{.symbol = "B", .pq = 1.0, .qty = 1});
+
+  // an untyped publisher putting the wrong payload on the topic
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  bus.publish(Event{.h = h, .p = std::string{"not a tick"}});
+
+  EXPECT_EQ(syms, (std::vector<std::string>{"A", "B"}));
+  EXPECT_EQ(seqs, (std::vector<uint64_t>{0, 2}));
+  EXPECT_EQ(alerts, 7);
+  EXPECT_EQ(bus.payload_mismatch(), 2u); // both MD_TICK subscribers skipped it
+  // every topic is counted, including the last one in the enum
+  const auto snap = bus.perf_snapshot();
+  const auto it = std::find_if(snap.topics.begin(), snap.topics.end(),
+                               [](const TopicStats& t){ return t.topic == Topic::RISK_ALERT; });
+  ASSERT_NE(it, snap.topics.end());
+  EXPECT_EQ(it->routed, 1u);
+  bus.stop();
+}
+
+TEST(Channel, TypedChannelDeliversInOrderFromManyProducers) {
+  Channel<Tick> ch(ChannelOptions{.capacity = 64});
+  EXPECT_EQ(ch.topic(), Topic::MD_TICK);
+
+  const int P = 3, N = 2000;
+  std::vector<int> last(P, -1);
+  std::atomic<int> got{0};
+  bool in_order = true;
+  auto id = ch.subscribe([&](const Tick& t, const Header& h){
+    const int p = t.symbol.name()[0] - 'a';
+    if (static_cast<int>(t.qty) != last[p] + 1) in_order = false;
+    last[p] = static_cast<int>(t.qty);
+    EXPECT_EQ(h.topic, Topic::MD_TICK);
+    got.fetch_add(1, std::memory_order_release);
+  });
+  std::atomic<int> other{0};
+  auto id2 = ch.subscribe([&](const Tick&){ other.fetch_add(1, std::memory_order_relaxed); });
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < P; ++p) {
+    producers.emplace_back([&ch, p]{
+      for (int i = 0; i < N; ++i) {
+        ch.publish(Tick{.symbol = std::string(1, static_cast<char>('a' + p)), .pq = 1.0,
+                        .qty = static_cast<uint32_t>(i)});
+      }
+    });
+  }
+  for (auto& t : producers) t.join();
+  while (got.load(std::memory_order_acquire) < P * N) std::this_thread::yield();
+
+  ch.unsubscribe(id2);
+  const int frozen = other.load();
+  EXPECT_EQ(frozen, P * N);
+  ch.publish(Tick{.symbol = "a", .pq = 1.0, .qty = static_cast<uint32_t>(N)});
+  ch.stop();
+  EXPECT_EQ(other.load(), frozen);
+  EXPECT_TRUE(in_order);
+  EXPECT_EQ(ch.dispatched(), static_cast<uint64_t>(P * N + 1));
+  ch.unsubscribe(id);
+}
+
+TEST(Channel, PublishGivesUpWhenStoppedOnAFullRing) {
+  Channel<Tick> ch(ChannelOptions{.capacity = 4});
+  std::atomic<bool> parked{false};
+  std::atomic<bool> release{false};
+  ch.subscribe([&](const Tick&){
+    parked.store(true);
+    while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  });
+
+  // one in the parked callback, then fill the ring
+  ASSERT_TRUE(ch.publish(Tick{.symbol = "A", .pq = 1.0, .qty = 0}));
+  while (!parked.load()) std::this_thread::yield();
+  uint32_t queued = 0;
+  while (ch.try_publish(Tick{.symbol = "A", .pq = 1.0, .qty = ++queued})) {}
+  --queued;
+
+  // a blocking publish waits on the full ring until stop() comes along
+  std::atomic<int> result{-1};
+  std::thread pub([&]{ result = ch.publish(Tick{.symbol = "A", .pq = 1.0, .qty = 99}) ? 1 : 0; });
+  while (ch.full() < 2) std::this_thread::yield();
+  std::thread stopper([&]{ ch.stop(); });
+  pub.join();
+  EXPECT_EQ(result.load(), 0);
+  EXPECT_EQ(ch.dropped(), 1u);
+
+  release.store(true);
+  stopper.join();
+  // everything counted as published was dispatched
+  EXPECT_EQ(ch.published(), 1u + queued);
+  EXPECT_EQ(ch.dispatched(), ch.published());
+  EXPECT_FALSE(ch.publish(Tick{.symbol = "A", .pq = 1.0, .qty = 100}));
+  EXPECT_FALSE(ch.try_publish(Tick{.symbol = "A", .pq = 1.0, .qty = 101}));
+}
+
+TEST(Shm, EventRecordRoundTripsEveryPayload) {
+  std::vector<Payload> ps = {
+    std::monostate{},
+    Tick{.symbol = "NIFTY", .pq = 22500.25, .qty = 75},
+    std::string{"hello"},
+    Bar{.symbol = "B", .open = 1, .close = 2, .high = 3, .low = 0.5, .volume = 9,
+        .start_ts_ns = 10, .end_ts_ns = 20},
+    Heartbeat{.t_ms = 42},
+    Order{.order_id = 7, .symbol = "O", .side = Side::Sell, .type = OrderType::Limit, .qty = 3, .price = 9.5},
+    Trade{.order_id = 7, .trade_id = 8, .symbol = "T", .side = Side::Buy, .qty = 3, .price = 9.75},
+    Reject{.order_id = 7, .symbol = "R", .code = 1001, .reason = "order_id=0"},
+    BookUpdate{.symbol = "K", .best_bid = 1.5, .best_ask = 1.75, .bid_qty = 4, .ask_qty = 6},
+    RiskAlert{.symbol = "A", .code = 3, .reason = "limit"},
+  };
+  for (const auto& p : ps) {
+    Event e;
+    e.h = Header{.seq = 5, .topic = Topic::ORDER, .ts_ns = 11, .t_pub_ns = 12};
+    e.p = p;
+    ShmEvent rec;
+    ASSERT_TRUE(to_shm(e, rec));
+    Event back;
+    ASSERT_TRUE(from_shm(rec, back));
+    EXPECT_EQ(serialize_event(back), serialize_event(e)) << p.index();
+  }
+
+  // too long for the record: truncated, flagged, still decodable
+  Event e;
+  e.h.topic = Topic::LOG;
+  e.p = std::string(500, 'x');
+  ShmEvent rec;
+  EXPECT_FALSE(to_shm(e, rec));
+  Event back;
+  ASSERT_TRUE(from_shm(rec, back));
+  EXPECT_EQ(std::get<std::string>(back.p).size(), ShmEvent::kTextCap);
+
+  // a reader's cache resolves each name once and hands back the same ids
+  ShmSymbolCache symbols;
+  const char* names[] = {"NIFTY", "NIFTY", "BANKNIFTY", "NIFTY", "", "BANKNIFTY"};
+  for (const char* n : names) {
+    Event t;
+    t.h.topic = Topic::MD_TICK;
+    t.p = Tick{.symbol = n, .pq = 1.0, .qty = 1};
+    ASSERT_TRUE(to_shm(t, rec));
+    ASSERT_TRUE(from_shm(rec, back, symbols));
+    EXPECT_EQ(std::get<Tick>(back.p).symbol, SymbolId(n)) << n;
+  }
+  EXPECT_EQ(symbols.size(), 2u);
+}
+
+TEST(Shm, CreateRefusesALiveRingUnlessReplacing) {
+  const std::string name = "md-test-excl-" + std::to_string(::getpid());
+  ShmRing first;
+  ASSERT_TRUE(first.create(name, 8));
+
+  // a second publisher must not silently take over the live ring
+  ShmRing second;
+  EXPECT_FALSE(second.create(name, 8));
+  ShmRing reader;
+  ASSERT_TRUE(reader.open(name));
+  EXPECT_EQ(reader.capacity(), 8u);
+
+  // explicit takeover works, and the old owner closing doesn't unlink it
+  ASSERT_TRUE(second.create(name, 16, /*replace=*/true));
+  first.close();
+  ShmRing again;
+  ASSERT_TRUE(again.open(name));
+  EXPECT_EQ(again.capacity(), 16u);
+}
+
+TEST(Shm, ReadersHaveOwnCursorsAndSkipAheadWhenLapped) {
+  const std::string name = "md-test-lap-" + std::to_string(::getpid());
+  ShmRing w;
+  ASSERT_TRUE(w.create(name, 8));
+  ShmWriter writer(w);
+
+  ShmRing r1, r2;
+  ASSERT_TRUE(r1.open(name));
+  ASSERT_TRUE(r2.open(name));
+  ShmReader fast(r1), slow(r2);
+
+  ShmEvent rec{}, out{};
+  auto put = [&](uint64_t i){ rec.seq = i; writer.write(rec); };
+  for (uint64_t i = 0; i < 4; ++i) put(i);
+  for (uint64_t i = 0; i < 4; ++i) {
+    ASSERT_EQ(fast.read(out), ShmReader::Read::Ok);
+    EXPECT_EQ(out.seq, i);
+  }
+  EXPECT_EQ(fast.read(out), ShmReader::Read::Empty);
+
+  // slow hasn't read anything; 20 more laps it (capacity 8)
+  for (uint64_t i = 4; i < 24; ++i) put(i);
+  ASSERT_EQ(slow.read(out), ShmReader::Read::Ok);
+  EXPECT_GT(out.seq, 15u);
+  EXPECT_EQ(slow.lost(), out.seq);
+  uint64_t last = out.seq;
+  while (slow.read(out) == ShmReader::Read::Ok) EXPECT_EQ(out.seq, ++last);
+  EXPECT_EQ(last, 23u);
+  // the other cursor didn't move
+  EXPECT_EQ(fast.position(), 4u);
+  EXPECT_EQ(fast.lost(), 0u);
+}
+
+TEST(Shm, PublisherAndSubscriberBridgeBusesAcrossProcesses) {
+  const std::string name = "md-test-xproc-" + std::to_string(::getpid());
+  constexpr int N = 1000;
+
+  const pid_t pid = ::fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    // child: its own bus, fed from the ring; exit code is the verdict
+    int rc = 0;
+    {
+      EventBus bus(BusOptions{.exec = ExecMode::Inline});
+      std::atomic<int> ticks{0};
+      bool ordered = true;
+      bus.subscribe<Topic::MD_TICK>([&](const Tick& t){
+        if (t.qty != static_cast<uint32_t>(ticks.load())) ordered = false;
+        ticks.fetch_add(1, std::memory_order_release);
+      });
+      std::atomic<int> logs{0};
+      bus.subscribe(Topic::LOG, [&](const Event&){ logs.fetch_add(1); });
+      SharedMemorySubscriber sub(bus, name);
+      const uint64_t deadline = now_ns() + 10'000'000'000ULL;
+      while (ticks.load(std::memory_order_acquire) < N && now_ns() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+      sub.stop();
+      if (ticks.load() != N) rc = 1;
+      else if (!ordered) rc = 2;
+      else if (logs.load() != 0) rc = 3; // publisher only forwards MD_TICK
+      else if (sub.lost() != 0) rc = 4;
+    }
+    ::_exit(rc);
+  }
+
+  EventBus bus(16384, 16384);
+  SharedMemoryPublisher pub(bus, name, ShmPublisherOptions{.capacity = 4096, .topics = {Topic::MD_TICK}});
+  ASSERT_TRUE(pub.ok());
+  for (int i = 0; i < 10'000 && pub.readers() == 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  ASSERT_EQ(pub.readers(), 1u);
+
+  for (int i = 0; i < N; ++i) {
+    bus.publish<Topic::MD_TICK>(Tick{.symbol = "NIFTY", .pq = 1.0, .qty = static_cast<uint32_t>(i)});
+    bus.publish<Topic::LOG>("not forwarded");
+  }
+  int status = 0;
+  ASSERT_EQ(::waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  EXPECT_EQ(pub.published(), static_cast<uint64_t>(N));
+  bus.stop();
+}
+
+TEST(Clock, TscClockIsMonotonicAndTracksSteadyClock) {
+  auto& c = TscClock::instance();
+  if (!c.usable()) GTEST_SKIP() << "no invariant TSC";
+
+  uint64_t prev = c.now_ns();
+  for (int i = 0; i < 1'000'000; ++i) {
+    const uint64_t t = c.now_ns();
+    ASSERT_GE(t, prev);
+    prev = t;
+  }
+  // same timeline as steady_clock; generous bound, the box may be busy
+  for (int i = 0; i < 5; ++i) {
+    const uint64_t before = steady_now_ns();
+    const uint64_t t = c.now_ns();
+    const uint64_t after = steady_now_ns();
+    EXPECT_GE(t + 200'000, before);
+    EXPECT_LE(t, after + 200'000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+}
+
+TEST(Bus, PublishStampsTsAndPubTimeWithOneClockRead) {
+  EventBus bus(64, 64);
+  bus.set_perf_enabled(true);
+  std::mutex mu;
+  std::vector<Header> got;
+  bus.subscribe(Topic::MD_TICK, [&](const Event& e){
+    std::scoped_lock lk(mu);
+    got.push_back(e.h);
+  });
+
+  const uint64_t t0 = now_ns();
+  Header h{};
+  h.topic = Topic::MD_TICK;
+  bus.publish(Event{.h = h, .p = Tick{.symbol = "X", .pq = 1.0, .qty = 1}});
+  EXPECT_TRUE(bus.try_publish(Event{.h = h, .p = Tick{.symbol = "X", .pq = 2.0, .qty = 1}}));
+  for (int i = 0; i < 1000; ++i) {
+    { std::scoped_lock lk(mu); if (got.size() == 2) break; }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  bus.stop();
+  ASSERT_EQ(got.size(), 2u);
+  for (const auto& g : got) {
+    EXPECT_EQ(g.ts_ns, g.t_pub_ns);
+    EXPECT_GE(g.ts_ns, t0);
+  }
+}
+
+TEST(Symbol, InternsDenseIdsAndMapsBackToNames) {
+  auto& tab = SymbolTable::global();
+  EXPECT_EQ(SymbolId{}.id(), 0u);
+  EXPECT_TRUE(SymbolId{""}.empty());
+
+  const uint32_t before = tab.size();
+  EXPECT_EQ(tab.find("SYMTEST-A"), SymbolTable::kNone);
+  const SymbolId a{"SYMTEST-A"};
+  const SymbolId b{std::string("SYMTEST-B")};
+  EXPECT_EQ(a.id(), before);
+  EXPECT_EQ(b.id(), before + 1);
+  EXPECT_EQ(SymbolId{"SYMTEST-A"}, a);
+  EXPECT_EQ(tab.find("SYMTEST-A"), a.id());
+  EXPECT_EQ(a.name(), "SYMTEST-A");
+  EXPECT_EQ(fmt::format("{}", b), "SYMTEST-B");
+  EXPECT_EQ(SymbolId::from_id(b.id()), b);
+  EXPECT_EQ(tab.name(tab.size() + 10), "");
+
+  // concurrent interning of the same names agrees on the ids
+  std::vector<std::thread> th;
+  std::vector<std::vector<uint32_t>> ids(4);
+  for (int t = 0; t < 4; ++t) {
+    th.emplace_back([&, t] {
+      for (int i = 0; i < 2000; ++i) ids[t].push_back(SymbolId{"SYMTEST-N" + std::to_string(i)}.id());
+    });
+  }
+  for (auto& x : th) x.join();
+  for (int t = 1; t < 4; ++t) EXPECT_EQ(ids[t], ids[0]);
+  EXPECT_EQ(tab.size(), before + 2 + 2000);
+
+  // text codec writes the name, parsing interns it again
+  Event e;
+  e.h.topic = Topic::MD_TICK;
+  e.p = Tick{.symbol = a, .pq = 1.5, .qty = 3};
+  const std::string line = serialize_event(e);
+  EXPECT_NE(line.find("TICK|SYMTEST-A|"), std::string::npos);
+  Event back;
+  ASSERT_TRUE(parse_event(line, back));
+  EXPECT_EQ(std::get<Tick>(back.p).symbol, a);
+}
+
+TEST(PodEvent, RoundTripsEveryPayloadThroughCacheLineRecord) {
+  std::vector<Payload> ps = {
+    std::monostate{},
+    Tick{.symbol = "NIFTY", .pq = 22500.25, .qty = 75},
+    std::string{"hello"},
+    Bar{.symbol = "B", .open = 1, .close = 2, .high = 3, .low = 0.5, .volume = 9,
+        .start_ts_ns = 10, .end_ts_ns = 20},
+    Heartbeat{.t_ms = 42},
+    Order{.order_id = 7, .symbol = "O", .side = Side::Sell, .type = OrderType::Limit, .qty = 3, .price = 9.5},
+    Trade{.order_id = 7, .trade_id = 8, .symbol = "T", .side = Side::Buy, .qty = 3, .price = 9.75},
+    Reject{.order_id = 7, .symbol = "R", .code = 1001, .reason = "order_id=0"},
+    BookUpdate{.symbol = "K", .best_bid = 1.5, .best_ask = 1.75, .bid_qty = 4, .ask_qty = 6},
+    RiskAlert{.symbol = "A", .code = 3, .reason = "limit"},
+  };
+  // records live in plain arrays, aligned to cache lines
+  std::vector<PodEvent> recs(ps.size());
+  for (size_t i = 0; i < ps.size(); ++i) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&recs[i]) % 64, 0u);
+    Event e;
+    e.h = Header{.seq = 5, .topic = Topic::ORDER, .ts_ns = 11, .t_pub_ns = 12};
+    e.p = ps[i];
+    ASSERT_TRUE(to_pod(e, recs[i]));
+    EXPECT_EQ(recs[i].symbol, symbol_of(e.p));
+
+    // a memcpy'd record decodes to the same event, which encodes to the same bytes
+    PodEvent copy;
+    std::memcpy(static_cast<void*>(&copy), &recs[i], sizeof(PodEvent));
+    Event back;
+    ASSERT_TRUE(from_pod(copy, back));
+    EXPECT_EQ(back.p.index(), e.p.index());
+    EXPECT_EQ(back.h.seq, 5u);
+    EXPECT_EQ(back.h.t_pub_ns, 12u);
+    PodEvent again;
+    ASSERT_TRUE(to_pod(back, again));
+    EXPECT_EQ(std::memcmp(&again, &recs[i], sizeof(PodEvent)), 0) << i;
+  }
+
+  // text too long for the record: truncated, flagged, still decodable
+  Event e;
+  e.h.topic = Topic::REJECT;
+  e.p = Reject{.order_id = 1, .symbol = "R", .code = 1, .reason = std::string(200, 'r')};
+  PodEvent rec;
+  EXPECT_FALSE(to_pod(e, rec));
+  Event back;
+  ASSERT_TRUE(from_pod(rec, back));
+  EXPECT_EQ(std::get<Reject>(back.p).reason, std::string(PodEvent::kReasonCap, 'r'));
+
+  rec.kind = 200;
+  EXPECT_FALSE(from_pod(rec, back));
+}
+
+TEST(Price, FixedPointFormatsAndParsesExactly) {
+  // integer math: no 0.1 + 0.2 != 0.3
+  EXPECT_EQ(Price(0.1) + Price(0.2), Price(0.3));
+  EXPECT_EQ(Price(22500.25).raw(), 2'250'025'000'000);
+
+  // out of range doubles saturate instead of overflowing the int64 cast
+  EXPECT_EQ(Price(1e11), Price::max());
+  EXPECT_EQ(Price(-1e11), Price::min());
+  EXPECT_EQ(Price(std::numeric_limits<double>::infinity()), Price::max());
+  EXPECT_EQ(Price(-std::numeric_limits<double>::infinity()), Price::min());
+  EXPECT_EQ(Price(std::numeric_limits<double>::quiet_NaN()), Price{});
+  EXPECT_EQ(Price(92'233'720'368.0).raw(), 9'223'372'036'800'000'000);
+
+  EXPECT_EQ(format_price(Price(22500.25)), "22500.25");
+  EXPECT_EQ(format_price(Price(-3.0)), "-3");
+  EXPECT_EQ(format_price(Price::from_raw(1)), "0.00000001");
+  EXPECT_EQ(format_price(Price::min()), "-92233720368.54775808");
+
+  Price p;
+  ASSERT_TRUE(parse_price("22500.250000", p)); // what to_string(double) used to write
+  EXPECT_EQ(p, Price(22500.25));
+  ASSERT_TRUE(parse_price("-0.00000001", p));
+  EXPECT_EQ(p.raw(), -1);
+  ASSERT_TRUE(parse_price("1.000000005", p)); // 9th digit rounds
+  EXPECT_EQ(p.raw(), 100'000'001);
+  ASSERT_TRUE(parse_price(".5", p));
+  EXPECT_EQ(p, Price(0.5));
+  for (const char* bad : {"", "-", ".", "1.2.3", "abc", "12x", "1e5", "99999999999999"}) {
+    EXPECT_FALSE(parse_price(bad, p)) << bad;
+  }
+  for (int64_t raw : {int64_t{0}, int64_t{1}, int64_t{-123456789}, int64_t{2'250'025'000'000}}) {
+    ASSERT_TRUE(parse_price(format_price(Price::from_raw(raw)), p));
+    EXPECT_EQ(p.raw(), raw);
+  }
+
+  // per-symbol grid
+  const SymbolId sym("PX_GRID");
+  EXPECT_EQ(price_decimals(sym), Price::kDecimals);
+  set_price_decimals(sym, 2);
+  EXPECT_EQ(price_decimals(sym), 2);
+  EXPECT_EQ(to_price(22500.254999, sym), Price(22500.25));
+  EXPECT_EQ(to_price(22500.255, sym), Price(22500.26));
+  EXPECT_TRUE(Price(22500.25).on_grid(2));
+  EXPECT_FALSE(Price(22500.251).on_grid(2));
+  // saturated feed values round without overflowing
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  EXPECT_EQ(to_price(inf, sym), Price::max());
+  EXPECT_EQ(to_price(-inf, sym), Price::min());
+  EXPECT_EQ(to_price(1e12, sym), Price::max());
+  EXPECT_EQ(to_price(-1e12, sym), Price::min());
+  EXPECT_EQ(to_price(92'233'720'368.53, sym).raw(), 9'223'372'036'853'000'000);
+  EXPECT_EQ(to_price(-92'233'720'368.53, sym).raw(), -9'223'372'036'853'000'000);
+  // the next grid point would not fit: left as is
+  const Price top = Price::from_raw(9'223'372'036'854'700'000);
+  EXPECT_EQ(top.rounded(2), top);
+  EXPECT_EQ((-top).rounded(2), -top);
+  EXPECT_EQ(Price(-0.005).rounded(2), Price(-0.01));
+  EXPECT_EQ(Price(-0.0049).rounded(2), Price{});
+
+  // the codec round-trips a tick price bit for bit
+  Event e;
+  e.h.topic = Topic::MD_TICK;
+  e.p = Tick{.symbol = "PX_GRID", .pq = Price::from_raw(2'250'025'000'001), .qty = 7};
+  Event back;
+  ASSERT_TRUE(parse_event(serialize_event(e), back));
+  EXPECT_EQ(std::get<Tick>(back.p).pq.raw(), 2'250'025'000'001);
+}
+
+TEST(Price, RouterAndAccountUseExactPrices) {
+  BusOptions o;
+  o.exec = ExecMode::Inline;
+  EventBus bus(o);
+  OrderRouter router(bus);
+
+  std::vector<Trade> trades;
+  std::vector<Reject> rejects;
+  bus.subscribe<Topic::TRADE>([&](const Trade& t){ trades.push_back(t); });
+  bus.subscribe<Topic::REJECT>([&](const Reject& r){ rejects.push_back(r); });
+
+  const SymbolId sym("PX_ROUTE");
+  set_price_decimals(sym, 2);
+  bus.publish<Topic::MD_TICK>(Tick{.symbol = sym, .pq = Price(0.1) + Price(0.2), .qty = 1});
+
+  // a limit exactly at the last price is marketable
+  bus.publish<Topic::ORDER>(Order{.order_id = 1, .symbol = sym, .side = Side::Buy,
+                                  .type = OrderType::Limit, .qty = 10, .price = 0.3});
+  // off the 0.01 grid
+  bus.publish<Topic::ORDER>(Order{.order_id = 2, .symbol = sym, .side = Side::Buy,
+                                  .type = OrderType::Limit, .qty = 10, .price = 0.305});
+  ASSERT_EQ(trades.size(), 1u);
+  EXPECT_EQ(trades[0].order_id, 1u);
+  EXPECT_EQ(trades[0].price, Price(0.3));
+  ASSERT_EQ(rejects.size(), 1u);
+  EXPECT_EQ(rejects[0].order_id, 2u);
+  EXPECT_EQ(rejects[0].code, 1005);
+
+  // PnL is exact: (0.31 - 0.3) * 10 = 0.1, not 0.09999...
+  Account acct(Price(1000.0));
+  acct.open_long(sym, 10, trades[0].price, 1);
+  acct.close_position(0.31, 2, ExitReason::Threshold);
+  EXPECT_EQ(acct.realized_pnl(), Price(0.1));
+  ASSERT_EQ(acct.trades().size(), 1u);
+  EXPECT_EQ(acct.trades()[0].pnl, Price(0.1));
+}